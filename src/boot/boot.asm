@@ -89,7 +89,7 @@ gdt_descriptor:
  [BITS 32]
  load32:
     mov eax, 1
-    mov ecx, 150
+    mov ecx, 199            ; ADDED: everything up to the FAT (ReservedSectors - 1)
     mov edi, 0x0100000
     call ata_lba_read
     jmp CODE_SEG:0x0100000
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "keyboard/keyboard.h"
 
 /* CONSTANTS */
 #define VGA_WIDTH 320
@@ -128,15 +129,47 @@ typedef struct {
     int music_note;
 } game_state_t;
 
+/* PROFILER STAGES (timed every frame, see timer/profiler.h) */
+typedef enum {
+    PROF_FRAME = 0,
+    PROF_UPDATE_BALLS,
+    PROF_UPDATE_BRICKS,
+    PROF_UPDATE_POWERUPS,
+    PROF_UPDATE_PARTICLES,
+    PROF_UPDATE_LASERS,
+    PROF_RENDER_BEGIN,
+    PROF_DRAW_BRICKS,
+    PROF_DRAW_PADDLE,
+    PROF_DRAW_BALLS,
+    PROF_DRAW_POWERUPS,
+    PROF_DRAW_LASERS,
+    PROF_DRAW_PARTICLES,
+    PROF_DRAW_HUD,
+    PROF_PRESENT,
+    PROF_STAGE_COUNT
+} profiler_stage_t;
+
 /* FUNCTION PROTOTYPES */
 void breakout_init(int num_players);
 void breakout_run();
 
+// Game rules and drawing without any hardware access (breakout_game.c)
+void breakout_handle_key(key_event_t* event);
+bool breakout_update();
+void breakout_render();
+void shoot_laser(player_t* player);
+void update_lasers();
+
 void play_sound(int frequency, int duration_ms);
 void stop_sound();
 void update_music();
 
+void render_invalidate();
+void render_begin_frame();
+
 void draw_bricks();
+void brick_layer_update(int row, int col);
+void brick_layer_rebuild();
 void draw_balls();
 void draw_paddle();
 void draw_powerups();
@@ -156,9 +189,25 @@ void spawn_explosion(int x, int y, uint8_t color);
 void update_particles();
 
 void draw_hud();
+void invalidate_hud();
+bool hud_overlaps(int x, int y, int width, int height);
 void draw_level_start_screen();
 void draw_turn_transition();
 void draw_winner_screen();
 void draw_countdown(int number);
+void draw_profiler_overlay();
+void draw_profiler_dump();
+
+int random_range(int min, int max);
+void random_seed(uint32_t seed);
+
+/* HEADLESS BENCHMARK (PEACHOS_BENCHMARK builds, see breakout_benchmark.c) */
+#define BENCHMARK_STATUS_OK      0
+#define BENCHMARK_STATUS_TIMEOUT 1
+
+void benchmark_start();
+void benchmark_script_input();
+bool benchmark_frame_done(uint32_t frame_us);
+void benchmark_finish(int status);
 
 #endif // BREAKOUT_H
\ No newline at end of file
@@ -0,0 +1,312 @@
+/*
+ * breakout_benchmark.c - Headless benchmark run
+ *
+ * A PEACHOS_BENCHMARK build (make benchmark) skips the menu and plays a
+ * single-player game with nobody at the keyboard:
+ * - Input comes from a fixed script fed through the real keyboard buffer:
+ *   the paddle follows the ball, aiming at a different spot of the paddle
+ *   in each phase, and some phases keep firing lasers
+ * - The random generator starts from a fixed seed and every frame runs
+ *   exactly one game step, so each run plays the same game
+ * - A game over restarts the game; the level start screen is skipped
+ *
+ * After BENCHMARK_FRAMES gameplay frames the results go out over COM1 as
+ * telemetry records ("CNT ... bench.*", plus the usual profiler table and
+ * counters) and QEMU is told to exit through its isa-debug-exit device.
+ * QEMU's exit status is then (status << 1) | 1.
+ */
+
+#include "keyboard/keyboard.h"
+#include "graphics/vga.h"
+#include "timer/timer.h"
+#include "telemetry/telemetry.h"
+#include "serial/serial.h"
+#include "io/io.h"
+#include "breakout.h"
+
+// External references
+extern game_state_t game;
+
+// Gameplay frames to run (make benchmark BENCH_FRAMES=n overrides this)
+#ifndef BENCHMARK_FRAMES
+#define BENCHMARK_FRAMES 3000
+#endif
+
+#define BENCHMARK_SEED 12345
+
+// Give up if the frames haven't been run after this long (wall clock)
+#define BENCHMARK_TIMEOUT_MS (5 * 60 * 1000)
+
+// QEMU -device isa-debug-exit,iobase=0xf4,iosize=0x04
+#define BENCHMARK_EXIT_PORT 0xF4
+
+// Frame time histogram for the percentile: 50 us buckets up to 25.6 ms
+#define BENCHMARK_BUCKET_US 50
+#define BENCHMARK_BUCKETS 512
+
+#define KEY_LEFT  0x4B
+#define KEY_RIGHT 0x4D
+#define KEY_LASER 0x1D
+#define KEY_SPACE 0x39
+
+/* ============================================================================
+ * INPUT SCRIPT
+ * ============================================================================
+ */
+
+struct benchmark_phase
+{
+    uint32_t frames;    // How long the phase lasts
+    int aim;            // Where the ball should meet the paddle, from its center
+    bool fire;          // Hold down the laser key
+};
+
+// Played in order, then again from the top
+static const struct benchmark_phase benchmark_script[] = {
+    {300,   0, false},
+    {300, -12, true},
+    {300,  12, false},
+    {300,  -6, true},
+    {300,   6, false},
+    {300, -16, true},
+    {300,  16, true},
+};
+
+#define BENCHMARK_PHASES (sizeof(benchmark_script) / sizeof(benchmark_script[0]))
+
+/* ============================================================================
+ * RESULTS
+ * ============================================================================
+ */
+
+static uint32_t bench_start_ticks = 0;
+static uint32_t bench_frames = 0;
+static uint32_t bench_input_frame = 0xFFFFFFFF;
+static uint32_t bench_restarts = 0;
+
+static uint64_t bench_total_us = 0;
+static uint32_t bench_min_us = 0xFFFFFFFF;
+static uint32_t bench_max_us = 0;
+static uint32_t bench_buckets[BENCHMARK_BUCKETS];
+static uint32_t bench_overflow = 0;
+
+/*
+ * current_phase - Script phase for the current frame
+ */
+static const struct benchmark_phase* current_phase()
+{
+    uint32_t cycle = 0;
+    for (uint32_t i = 0; i < BENCHMARK_PHASES; i++)
+    {
+        cycle += benchmark_script[i].frames;
+    }
+
+    uint32_t frame = bench_frames % cycle;
+    for (uint32_t i = 0; i < BENCHMARK_PHASES; i++)
+    {
+        if (frame < benchmark_script[i].frames)
+        {
+            return &benchmark_script[i];
+        }
+        frame -= benchmark_script[i].frames;
+    }
+    return &benchmark_script[0];
+}
+
+/*
+ * tracked_ball - The ball the paddle should go for
+ *
+ * The lowest ball that is falling; if none is, the lowest ball.
+ */
+static ball_t* tracked_ball()
+{
+    ball_t* best = 0;
+    for (int i = 0; i < MAX_BALLS; i++)
+    {
+        ball_t* ball = &game.balls[i];
+        if (!ball->active)
+        {
+            continue;
+        }
+
+        if (!best ||
+            (ball->dy > 0 && best->dy <= 0) ||
+            ((ball->dy > 0) == (best->dy > 0) && ball->y > best->y))
+        {
+            best = ball;
+        }
+    }
+    return best;
+}
+
+static void press(uint8_t scancode)
+{
+    keyboard_inject(scancode, true);
+    keyboard_inject(scancode, false);
+}
+
+/*
+ * percentile_us - Frame time below which the given share of frames fell
+ *
+ * Returns the upper edge of the bucket, so it is accurate to
+ * BENCHMARK_BUCKET_US.
+ */
+static uint32_t percentile_us(uint32_t percent)
+{
+    uint32_t wanted = (uint32_t)timer_udiv64((uint64_t)bench_frames * percent + 99, 100);
+    uint32_t seen = 0;
+
+    for (int i = 0; i < BENCHMARK_BUCKETS; i++)
+    {
+        seen += bench_buckets[i];
+        if (seen >= wanted)
+        {
+            return (i + 1) * BENCHMARK_BUCKET_US;
+        }
+    }
+    return bench_max_us;
+}
+
+/*
+ * benchmark_start - Reset the results and seed the game (before breakout_init)
+ */
+void benchmark_start()
+{
+    random_seed(BENCHMARK_SEED);
+
+    bench_start_ticks = timer_get_ticks();
+    bench_frames = 0;
+    bench_input_frame = 0xFFFFFFFF;
+    bench_restarts = 0;
+    bench_total_us = 0;
+    bench_min_us = 0xFFFFFFFF;
+    bench_max_us = 0;
+    bench_overflow = 0;
+    for (int i = 0; i < BENCHMARK_BUCKETS; i++)
+    {
+        bench_buckets[i] = 0;
+    }
+
+    telemetry_value("bench.target_frames", BENCHMARK_FRAMES);
+    telemetry_log("bench: started");
+}
+
+/*
+ * benchmark_script_input - Queue this frame's key presses
+ *
+ * Called at the top of every pass through the game loop, before the
+ * keyboard buffer is read. Presses are queued once per gameplay frame;
+ * a game over is answered with Space straight away.
+ */
+void benchmark_script_input()
+{
+    if (timer_get_ticks() - bench_start_ticks >= BENCHMARK_TIMEOUT_MS)
+    {
+        telemetry_log("bench: timed out");
+        benchmark_finish(BENCHMARK_STATUS_TIMEOUT);
+    }
+
+    if (game.all_players_done)
+    {
+        bench_restarts++;
+        press(KEY_SPACE);
+        return;
+    }
+
+    if (bench_input_frame == bench_frames)
+    {
+        return;
+    }
+    bench_input_frame = bench_frames;
+
+    const struct benchmark_phase* phase = current_phase();
+    player_t* player = &game.players[game.current_player];
+    ball_t* ball = tracked_ball();
+
+    if (ball)
+    {
+        int target = ball->x + BALL_SIZE / 2 - phase->aim;
+        int paddle = player->paddle_x + player->paddle_width / 2;
+
+        // One press moves the paddle PADDLE_SPEED * 2, so don't chase
+        // anything closer than that or it just oscillates
+        if (target < paddle - PADDLE_SPEED * 2)
+        {
+            press(KEY_LEFT);
+        }
+        else if (target > paddle + PADDLE_SPEED * 2)
+        {
+            press(KEY_RIGHT);
+        }
+    }
+
+    if (phase->fire)
+    {
+        press(KEY_LASER);
+    }
+}
+
+/*
+ * benchmark_frame_done - Record one gameplay frame
+ *
+ * Returns true once BENCHMARK_FRAMES frames have been recorded.
+ */
+bool benchmark_frame_done(uint32_t frame_us)
+{
+    bench_frames++;
+    bench_total_us += frame_us;
+    if (frame_us < bench_min_us)
+    {
+        bench_min_us = frame_us;
+    }
+    if (frame_us > bench_max_us)
+    {
+        bench_max_us = frame_us;
+    }
+
+    uint32_t bucket = frame_us / BENCHMARK_BUCKET_US;
+    if (bucket < BENCHMARK_BUCKETS)
+    {
+        bench_buckets[bucket]++;
+    }
+    else
+    {
+        bench_overflow++;
+    }
+
+    return bench_frames >= BENCHMARK_FRAMES;
+}
+
+/*
+ * benchmark_finish - Publish the results and leave QEMU
+ *
+ * Does not return. Without the isa-debug-exit device (real hardware,
+ * or QEMU started without it) the machine just halts.
+ */
+void benchmark_finish(int status)
+{
+    uint32_t elapsed_ms = timer_get_ticks() - bench_start_ticks;
+
+    telemetry_value("bench.status", status);
+    telemetry_value("bench.frames", bench_frames);
+    telemetry_value("bench.restarts", bench_restarts);
+    telemetry_value("bench.elapsed_ms", elapsed_ms);
+    if (bench_frames > 0)
+    {
+        telemetry_value("bench.frame_us_min", bench_min_us);
+        telemetry_value("bench.frame_us_avg", (uint32_t)timer_udiv64(bench_total_us, bench_frames));
+        telemetry_value("bench.frame_us_p50", percentile_us(50));
+        telemetry_value("bench.frame_us_p99", percentile_us(99));
+        telemetry_value("bench.frame_us_max", bench_max_us);
+        telemetry_value("bench.frame_us_overflow", bench_overflow);
+    }
+    telemetry_log(status == BENCHMARK_STATUS_OK ? "bench: done" : "bench: failed");
+    serial_flush();
+
+    outb(BENCHMARK_EXIT_PORT, status);
+
+    while (1)
+    {
+        __asm__ volatile("hlt");
+    }
+}
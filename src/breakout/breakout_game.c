@@ -0,0 +1,345 @@
+/*
+ * breakout_game.c - Game state and rules
+ *
+ * Everything about the game itself: levels, lasers, key handling and one
+ * fixed simulation step, plus drawing a frame into the back buffer. None
+ * of it touches hardware directly - breakout_main.c runs the loop against
+ * the keyboard, timer and screen, and the host build (make host) runs the
+ * same code against fakes of those.
+ */
+
+#include "keyboard/keyboard.h"
+#include "graphics/vga.h"
+#include "timer/profiler.h"
+#include "breakout.h"
+
+/* GLOBAL GAME STATE */
+game_state_t game;
+
+/* LEVEL DEFINITIONS */
+level_t levels[MAX_LEVELS] = {
+    // LEVEL 1: CLASSIC
+    {
+        .pattern = {
+            {1,1,1,1,1,1,1,1,1,1,1,1},
+            {1,1,1,1,1,1,1,1,1,1,1,1},
+            {1,1,1,1,1,1,1,1,1,1,1,1},
+            {1,1,1,1,1,1,1,1,1,1,1,1},
+            {1,1,1,1,1,1,1,1,1,1,1,1}
+        },
+        .colors = {4, 12, 14, 2, 1},
+        .ball_speed = 2,
+        .name = "CLASSIC"
+    },
+    
+    // LEVEL 2: CHECKERBOARD
+    {
+        .pattern = {
+            {2,0,2,0,2,0,2,0,2,0,2,0},
+            {0,2,0,2,0,2,0,2,0,2,0,2},
+            {2,0,2,0,2,0,2,0,2,0,2,0},
+            {0,2,0,2,0,2,0,2,0,2,0,2},
+            {2,0,2,0,2,0,2,0,2,0,2,0}
+        },
+        .colors = {12, 12, 14, 14, 2},
+        .ball_speed = 3,
+        .name = "CHECKERBOARD"
+    },
+    
+    // LEVEL 3: PYRAMID
+    {
+        .pattern = {
+            {0,0,0,0,0,3,3,0,0,0,0,0},
+            {0,0,0,0,2,2,2,2,0,0,0,0},
+            {0,0,0,2,2,2,2,2,2,0,0,0},
+            {0,0,2,2,2,2,2,2,2,2,0,0},
+            {0,2,2,2,2,2,2,2,2,2,2,0}
+        },
+        .colors = {4, 12, 14, 2, 1},
+        .ball_speed = 3,
+        .name = "PYRAMID"
+    },
+    
+    // LEVEL 4: BOSS
+    {
+        .pattern = {
+            {3,3,3,3,3,3,3,3,3,3,3,3},
+            {3,0,0,3,3,3,3,3,3,0,0,3},
+            {3,3,3,3,3,3,3,3,3,3,3,3},
+            {3,0,0,3,3,3,3,3,3,0,0,3},
+            {3,3,3,3,3,3,3,3,3,3,3,3}
+        },
+        .colors = {4, 4, 12, 12, 14},
+        .ball_speed = 4,
+        .name = "BOSS"
+    }
+};
+
+/* EXTERNAL FUNCTION DECLARATIONS */
+extern void init_bricks();
+extern void init_balls();
+extern void update_balls();
+extern void update_bricks();
+extern bool check_level_complete();
+extern void update_powerups();
+extern void update_particles();
+extern void draw_rect(int x, int y, int width, int height, uint8_t color);
+extern void draw_bricks();
+extern void draw_balls();
+extern void draw_paddle();
+extern void draw_powerups();
+extern void draw_lasers();
+extern void draw_particles();
+extern void draw_hud();
+extern void draw_level_start_screen();
+extern void draw_turn_transition();
+extern void draw_winner_screen();
+extern void draw_countdown(int number);
+
+/* LASER SYSTEM */
+void shoot_laser(player_t* player)
+{
+    if (!player->has_laser || player->laser_cooldown > 0)
+    {
+        return;
+    }
+    
+    for (int i = 0; i < MAX_LASERS; i++)
+    {
+        if (!game.lasers[i].active)
+        {
+            game.lasers[i].x = player->paddle_x + player->paddle_width / 2;
+            game.lasers[i].y = PADDLE_Y - 5;
+            game.lasers[i].active = true;
+            player->laser_cooldown = 10;
+            return;
+        }
+    }
+}
+
+void update_lasers()
+{
+    player_t* player = &game.players[game.current_player];
+    
+    if (player->laser_cooldown > 0)
+    {
+        player->laser_cooldown--;
+    }
+    
+    for (int i = 0; i < MAX_LASERS; i++)
+    {
+        if (!game.lasers[i].active)
+        {
+            continue;
+        }
+        
+        game.lasers[i].y -= 5;
+        
+        for (int row = 0; row < BRICK_ROWS; row++)
+        {
+            for (int col = 0; col < BRICK_COLS; col++)
+            {
+                if (game.bricks[row][col].health == 0)
+                {
+                    continue;
+                }
+                
+                int brick_x = col * (BRICK_WIDTH + 2) + BRICK_OFFSET_X;
+                int brick_y = row * (BRICK_HEIGHT + 2) + BRICK_OFFSET_Y;
+                
+                if (game.lasers[i].x >= brick_x && 
+                    game.lasers[i].x < brick_x + BRICK_WIDTH &&
+                    game.lasers[i].y >= brick_y && 
+                    game.lasers[i].y < brick_y + BRICK_HEIGHT)
+                {
+                    game.bricks[row][col].health--;
+                    brick_layer_update(row, col);
+                    game.lasers[i].active = false;
+                    
+                    if (game.bricks[row][col].health == 0)
+                    {
+                        player->score += 10;
+                        extern void spawn_explosion(int x, int y, uint8_t color);
+                        extern void spawn_powerup(int x, int y);
+                        spawn_explosion(brick_x + BRICK_WIDTH/2, brick_y + BRICK_HEIGHT/2,
+                                      levels[game.level].colors[row]);
+                        spawn_powerup(brick_x, brick_y);
+                        game.screen_shake_timer = 3;
+                    }
+                    
+                    goto next_laser;
+                }
+            }
+        }
+        
+        next_laser:
+        
+        if (game.lasers[i].y < 0)
+        {
+            game.lasers[i].active = false;
+        }
+    }
+}
+
+/* INPUT HANDLING */
+void breakout_handle_key(key_event_t* event)
+{
+    if (!event->pressed)
+    {
+        return;
+    }
+    
+    if (game.all_players_done)
+    {
+        if (event->scancode == 0x39)  // Space
+        {
+            breakout_init(game.num_players);
+        }
+        return;
+    }
+    
+    player_t* player = &game.players[game.current_player];
+    
+    // Left
+    if (event->scancode == 0x4B || event->scancode == 0x1E)
+    {
+        player->paddle_x -= PADDLE_SPEED * 2;
+        if (player->paddle_x < 0)
+        {
+            player->paddle_x = 0;
+        }
+    }
+    
+    // Right
+    if (event->scancode == 0x4D || event->scancode == 0x20)
+    {
+        player->paddle_x += PADDLE_SPEED * 2;
+        if (player->paddle_x > VGA_WIDTH - player->paddle_width)
+        {
+            player->paddle_x = VGA_WIDTH - player->paddle_width;
+        }
+    }
+    
+    // Shoot laser
+    if (event->scancode == 0x1D)
+    {
+        shoot_laser(player);
+    }
+}
+
+/* GAME INITIALIZATION - SIMPLIFIED */
+void breakout_init(int num_players)
+{
+    game.num_players = (num_players <= MAX_PLAYERS) ? num_players : 1;
+    game.current_player = 0;
+    game.level = 0;
+    game.all_players_done = false;
+    
+    game.music_note = 0;
+    game.music_timer = 0;
+    game.screen_shake_timer = 0;
+    game.screen_shake_x = 0;
+    game.screen_shake_y = 0;
+    
+    // Initialize both players - FIXED VALUES
+    for (int p = 0; p < MAX_PLAYERS; p++)
+    {
+        game.players[p].lives = 3;  // Fixed: 3 lives
+        game.players[p].score = 0;
+        game.players[p].paddle_width = PADDLE_WIDTH;  // Fixed: 40px
+        game.players[p].paddle_x = VGA_WIDTH / 2 - game.players[p].paddle_width / 2;
+        game.players[p].has_laser = false;
+        game.players[p].laser_cooldown = 0;
+        game.players[p].turn_complete = false;
+        game.players[p].ball_speed_multiplier = 1.0f;
+    }
+    
+    // Deactivate all lasers
+    for (int i = 0; i < MAX_LASERS; i++)
+    {
+        game.lasers[i].active = false;
+    }
+    
+    init_bricks();
+    init_balls();
+    render_invalidate();
+    
+    for (int i = 0; i < MAX_POWERUPS; i++)
+    {
+        game.powerups[i].active = false;
+    }
+    
+    for (int i = 0; i < MAX_PARTICLES; i++)
+    {
+        game.particles[i].active = false;
+    }
+}
+
+/* ONE GAME STEP */
+
+/*
+ * breakout_update - Advance the game by one fixed 16 ms step
+ *
+ * Returns true if the step finished the level: either the next level has
+ * been set up (the caller shows its start screen) or the player's turn
+ * is over. Either way the remaining steps of the frame should be skipped.
+ */
+bool breakout_update()
+{
+    PROFILE(PROF_UPDATE_BALLS, update_balls());
+    PROFILE(PROF_UPDATE_BRICKS, update_bricks());
+    PROFILE(PROF_UPDATE_POWERUPS, update_powerups());
+    PROFILE(PROF_UPDATE_PARTICLES, update_particles());
+    PROFILE(PROF_UPDATE_LASERS, update_lasers());
+    
+    bool level_over = false;
+    
+    if (check_level_complete())
+    {
+        game.level++;
+        level_over = true;
+        
+        if (game.level >= MAX_LEVELS)
+        {
+            game.players[game.current_player].turn_complete = true;
+        }
+        else
+        {
+            init_bricks();
+            init_balls();
+        }
+    }
+    
+    // Screen shake
+    if (game.screen_shake_timer > 0)
+    {
+        game.screen_shake_timer--;
+        game.screen_shake_x = random_range(-2, 2);
+        game.screen_shake_y = random_range(-2, 2);
+    }
+    else
+    {
+        game.screen_shake_x = 0;
+        game.screen_shake_y = 0;
+    }
+    
+    return level_over || game.players[game.current_player].turn_complete;
+}
+
+/*
+ * breakout_render - Draw the frame into the back buffer
+ *
+ * Only what changed since the last frame is redrawn; vga_present() is
+ * left to the caller.
+ */
+void breakout_render()
+{
+    PROFILE(PROF_RENDER_BEGIN, render_begin_frame());
+    PROFILE(PROF_DRAW_BRICKS, draw_bricks());
+    PROFILE(PROF_DRAW_PADDLE, draw_paddle());
+    PROFILE(PROF_DRAW_BALLS, draw_balls());
+    PROFILE(PROF_DRAW_POWERUPS, draw_powerups());
+    PROFILE(PROF_DRAW_LASERS, draw_lasers());
+    PROFILE(PROF_DRAW_PARTICLES, draw_particles());
+    PROFILE(PROF_DRAW_HUD, draw_hud());
+}
@@ -10,6 +10,9 @@
  * - Particle explosions
  * 
  * All drawing respects screen shake for impact effects!
+ * 
+ * Frames are redrawn incrementally: only what moved since the last frame
+ * (and whatever static content it uncovered) is erased and drawn again.
  */
 
 #include "keyboard/keyboard.h"
@@ -20,6 +23,38 @@
 // External references
 extern game_state_t game;
 extern level_t levels[MAX_LEVELS];
+extern void invalidate_hud();
+extern bool hud_overlaps(int x, int y, int width, int height);
+
+/* ============================================================================
+ * DIRTY-RECTANGLE FRAME STATE
+ * ============================================================================
+ */
+
+#define MAX_SPRITE_RECTS 256
+
+// Screen areas covered by moving objects this frame (erased next frame)
+static struct vga_rect sprite_rects[MAX_SPRITE_RECTS];
+static int sprite_count = 0;
+
+/*
+ * Brick layer: the whole brick field pre-rendered once. A brick is only
+ * drawn again (into the layer) when its health changes; the screen gets
+ * its pixels by copying from here.
+ */
+#define BRICK_FIELD_WIDTH  (BRICK_COLS * (BRICK_WIDTH + 2))
+#define BRICK_FIELD_HEIGHT (BRICK_ROWS * (BRICK_HEIGHT + 2))
+
+static uint8_t brick_layer_pixels[BRICK_FIELD_WIDTH * BRICK_FIELD_HEIGHT];
+static struct vga_surface brick_layer = {brick_layer_pixels, BRICK_FIELD_WIDTH, BRICK_FIELD_HEIGHT};
+static bool brick_layer_stale = true;
+
+// Bricks re-rendered into the layer but not yet copied to the screen
+static bool brick_changed[BRICK_ROWS][BRICK_COLS];
+
+static bool full_redraw = true;
+static int last_shake_x = 0;
+static int last_shake_y = 0;
 
 /* ============================================================================
  * HELPER DRAWING FUNCTIONS
@@ -34,39 +69,132 @@ extern level_t levels[MAX_LEVELS];
  */
 void draw_rect(int x, int y, int width, int height, uint8_t color)
 {
-    // Apply screen shake offset
-    x += game.screen_shake_x;
-    y += game.screen_shake_y;
+    // Apply screen shake offset; clipping happens once inside the fill
+    vga_fill_rect(x + game.screen_shake_x, y + game.screen_shake_y, width, height, color);
+}
+
+/*
+ * draw_outline - Draw a hollow rectangle border with screen shake
+ */
+void draw_outline(int x, int y, int width, int height, int thickness, uint8_t color)
+{
+    vga_outline_rect(x + game.screen_shake_x, y + game.screen_shake_y,
+                     width, height, thickness, color);
+}
+
+/*
+ * draw_pixel - Draw a single pixel with screen shake
+ */
+void draw_pixel(int x, int y, uint8_t color)
+{
+    // vga_set_pixel does the bounds check
+    vga_set_pixel(x + game.screen_shake_x, y + game.screen_shake_y, color);
+}
+
+/*
+ * track_sprite - Remember an area a moving object was drawn over
+ * 
+ * Next frame that area is erased back to the background before the
+ * object is drawn at its new position.
+ */
+static void track_sprite(int x, int y, int width, int height)
+{
+    struct vga_rect r = {x + game.screen_shake_x, y + game.screen_shake_y, width, height};
     
-    // Draw each pixel in the rectangle
-    for (int dy = 0; dy < height; dy++)
+    if (sprite_count < MAX_SPRITE_RECTS)
     {
-        for (int dx = 0; dx < width; dx++)
-        {
-            int px = x + dx;
-            int py = y + dy;
-            
-            // Bounds checking (don't draw off-screen)
-            if (px >= 0 && px < VGA_WIDTH && py >= 0 && py < VGA_HEIGHT)
-            {
-                vga_set_pixel(px, py, color);
-            }
-        }
+        sprite_rects[sprite_count++] = r;
+        return;
     }
+    
+    // Out of slots - grow the last rectangle to cover this one too
+    struct vga_rect* last = &sprite_rects[MAX_SPRITE_RECTS - 1];
+    int x2 = (last->x + last->width > r.x + r.width) ? last->x + last->width : r.x + r.width;
+    int y2 = (last->y + last->height > r.y + r.height) ? last->y + last->height : r.y + r.height;
+    if (r.x < last->x) last->x = r.x;
+    if (r.y < last->y) last->y = r.y;
+    last->width = x2 - last->x;
+    last->height = y2 - last->y;
 }
 
 /*
- * draw_pixel - Draw a single pixel with screen shake
+ * composite_bricks - Copy the brick layer into a screen area
  */
-void draw_pixel(int x, int y, uint8_t color)
+static void composite_bricks(int x, int y, int width, int height)
+{
+    int field_x = BRICK_OFFSET_X + game.screen_shake_x;
+    int field_y = BRICK_OFFSET_Y + game.screen_shake_y;
+    
+    // vga_blit clips away the part of the area outside the layer
+    vga_blit(&brick_layer, x - field_x, y - field_y, x, y, width, height);
+}
+
+/*
+ * render_invalidate - Force the next frame to be drawn from scratch
+ * 
+ * Called whenever something else (level screens, countdown) has painted
+ * over the play field. The bricks may have been reset for a new level in
+ * the meantime, so the brick layer is rebuilt as well.
+ */
+void render_invalidate()
+{
+    full_redraw = true;
+    brick_layer_stale = true;
+}
+
+/*
+ * render_begin_frame - Prepare the back buffer for drawing a new frame
+ * 
+ * Normally this only erases what the moving objects covered last frame,
+ * putting back the bricks underneath from the brick layer, and flags the
+ * HUD for repair. Screen shake moves everything, so a shake (or the end
+ * of one) falls back to a full redraw: clear plus one copy of the layer.
+ */
+void render_begin_frame()
 {
-    x += game.screen_shake_x;
-    y += game.screen_shake_y;
+    if (game.screen_shake_x != last_shake_x || game.screen_shake_y != last_shake_y)
+    {
+        full_redraw = true;
+    }
+    last_shake_x = game.screen_shake_x;
+    last_shake_y = game.screen_shake_y;
+    
+    if (brick_layer_stale)
+    {
+        brick_layer_rebuild();
+    }
     
-    if (x >= 0 && x < VGA_WIDTH && y >= 0 && y < VGA_HEIGHT)
+    if (full_redraw)
     {
-        vga_set_pixel(x, y, color);
+        vga_clear(0);
+        composite_bricks(0, 0, VGA_WIDTH, VGA_HEIGHT);
+        
+        for (int row = 0; row < BRICK_ROWS; row++)
+        {
+            for (int col = 0; col < BRICK_COLS; col++)
+            {
+                brick_changed[row][col] = false;
+            }
+        }
+        invalidate_hud();
+        full_redraw = false;
+    }
+    else
+    {
+        for (int i = 0; i < sprite_count; i++)
+        {
+            struct vga_rect* r = &sprite_rects[i];
+            vga_fill_rect(r->x, r->y, r->width, r->height, 0);
+            composite_bricks(r->x, r->y, r->width, r->height);
+            
+            if (hud_overlaps(r->x, r->y, r->width, r->height))
+            {
+                invalidate_hud();
+            }
+        }
     }
+    
+    sprite_count = 0;
 }
 
 /* ============================================================================
@@ -75,14 +203,96 @@ void draw_pixel(int x, int y, uint8_t color)
  */
 
 /*
- * draw_bricks - Draw all bricks with 3D gradient effect
+ * brick_layer_update - Re-render one brick into the brick layer
  * 
  * Each brick is drawn in 3 horizontal layers:
  * - Top layer: Lighter shade (highlight)
  * - Middle layer: Base color
  * - Bottom layer: Darker shade (shadow)
  * 
- * This creates a nice 3D look! Damaged bricks are darker.
+ * This creates a nice 3D look! Damaged bricks are darker, destroyed ones
+ * are cleared. Call this whenever a brick's health changes.
+ */
+void brick_layer_update(int row, int col)
+{
+    // Position inside the layer (no screen shake here)
+    int brick_x = col * (BRICK_WIDTH + 2);
+    int brick_y = row * (BRICK_HEIGHT + 2);
+    int health = game.bricks[row][col].health;
+    
+    brick_changed[row][col] = true;
+    
+    if (health == 0)
+    {
+        vga_surface_fill_rect(&brick_layer, brick_x, brick_y, BRICK_WIDTH, BRICK_HEIGHT, 0);
+        return;
+    }
+    
+    // Get base color from level
+    uint8_t base_color = levels[game.level].colors[row];
+    
+    // Damaged bricks look darker
+    if (health == 1)
+    {
+        base_color = 8;  // Dark gray
+    }
+    
+    // Calculate gradient colors for 3D effect
+    uint8_t light_color = base_color;
+    uint8_t dark_color = base_color;
+    
+    // Map base colors to lighter variants
+    if (base_color == 4) light_color = 12;  // Red -> Light red
+    if (base_color == 2) light_color = 10;  // Green -> Light green
+    if (base_color == 1) light_color = 9;   // Blue -> Light blue
+    
+    // Map to darker variants
+    if (base_color > 8)
+    {
+        dark_color = base_color - 4;
+    }
+    
+    // Draw 3 horizontal layers for gradient
+    vga_surface_fill_rect(&brick_layer, brick_x, brick_y, BRICK_WIDTH, 3, light_color);      // Top (light)
+    vga_surface_fill_rect(&brick_layer, brick_x, brick_y + 3, BRICK_WIDTH, 4, base_color);   // Middle
+    vga_surface_fill_rect(&brick_layer, brick_x, brick_y + 7, BRICK_WIDTH, 3, dark_color);   // Bottom (dark)
+    
+    // Draw black border for definition
+    vga_surface_outline_rect(&brick_layer, brick_x, brick_y, BRICK_WIDTH, BRICK_HEIGHT, 1, 0);
+    
+    // Draw health indicator dots (shows hits remaining)
+    for (int h = 0; h < health && h < 3; h++)
+    {
+        int dot_x = brick_x + 3 + h * 4;
+        int dot_y = brick_y + 2;
+        
+        // Draw 2x2 pixel dot (white)
+        vga_surface_fill_rect(&brick_layer, dot_x, dot_y, 2, 2, 15);
+    }
+}
+
+/*
+ * brick_layer_rebuild - Render the whole brick field into the layer
+ */
+void brick_layer_rebuild()
+{
+    vga_surface_fill_rect(&brick_layer, 0, 0, BRICK_FIELD_WIDTH, BRICK_FIELD_HEIGHT, 0);
+    
+    for (int row = 0; row < BRICK_ROWS; row++)
+    {
+        for (int col = 0; col < BRICK_COLS; col++)
+        {
+            brick_layer_update(row, col);
+        }
+    }
+    brick_layer_stale = false;
+}
+
+/*
+ * draw_bricks - Put bricks that changed since last frame on screen
+ * 
+ * The bricks themselves were already rendered into the brick layer when
+ * they were hit; this only copies those from the layer.
  */
 void draw_bricks()
 {
@@ -90,73 +300,15 @@ void draw_bricks()
     {
         for (int col = 0; col < BRICK_COLS; col++)
         {
-            // Skip destroyed bricks
-            if (game.bricks[row][col].health == 0)
+            if (!brick_changed[row][col])
             {
                 continue;
             }
+            brick_changed[row][col] = false;
             
-            // Calculate position (with screen shake offset)
-            int brick_x = col * (BRICK_WIDTH + 2) + BRICK_OFFSET_X;
-            int brick_y = row * (BRICK_HEIGHT + 2) + BRICK_OFFSET_Y;
-            
-            // Apply screen shake
-            brick_x += game.screen_shake_x;
-            brick_y += game.screen_shake_y;
-            
-            // Get base color from level
-            uint8_t base_color = levels[game.level].colors[row];
-            
-            // Damaged bricks look darker
-            if (game.bricks[row][col].health == 1)
-            {
-                base_color = 8;  // Dark gray
-            }
-            
-            // Calculate gradient colors for 3D effect
-            uint8_t light_color = base_color;
-            uint8_t dark_color = base_color;
-            
-            // Map base colors to lighter variants
-            if (base_color == 4) light_color = 12;  // Red -> Light red
-            if (base_color == 2) light_color = 10;  // Green -> Light green
-            if (base_color == 1) light_color = 9;   // Blue -> Light blue
-            
-            // Map to darker variants
-            if (base_color > 8)
-            {
-                dark_color = base_color - 4;
-            }
-            
-            // Draw 3 horizontal layers for gradient
-            draw_rect(brick_x, brick_y, BRICK_WIDTH, 3, light_color);      // Top (light)
-            draw_rect(brick_x, brick_y + 3, BRICK_WIDTH, 4, base_color);   // Middle
-            draw_rect(brick_x, brick_y + 7, BRICK_WIDTH, 3, dark_color);   // Bottom (dark)
-            
-            // Draw black border for definition
-            for (int i = 0; i < BRICK_WIDTH; i++)
-            {
-                draw_pixel(brick_x + i, brick_y, 0);
-                draw_pixel(brick_x + i, brick_y + BRICK_HEIGHT - 1, 0);
-            }
-            for (int i = 0; i < BRICK_HEIGHT; i++)
-            {
-                draw_pixel(brick_x, brick_y + i, 0);
-                draw_pixel(brick_x + BRICK_WIDTH - 1, brick_y + i, 0);
-            }
-            
-            // Draw health indicator dots (shows hits remaining)
-            for (int h = 0; h < game.bricks[row][col].health && h < 3; h++)
-            {
-                int dot_x = brick_x + 3 + h * 4;
-                int dot_y = brick_y + 2;
-                
-                // Draw 2x2 pixel dot (white)
-                draw_pixel(dot_x, dot_y, 15);
-                draw_pixel(dot_x + 1, dot_y, 15);
-                draw_pixel(dot_x, dot_y + 1, 15);
-                draw_pixel(dot_x + 1, dot_y + 1, 15);
-            }
+            int brick_x = col * (BRICK_WIDTH + 2) + BRICK_OFFSET_X + game.screen_shake_x;
+            int brick_y = row * (BRICK_HEIGHT + 2) + BRICK_OFFSET_Y + game.screen_shake_y;
+            composite_bricks(brick_x, brick_y, BRICK_WIDTH, BRICK_HEIGHT);
         }
     }
 }
@@ -184,6 +336,8 @@ void draw_balls()
         // Draw trail (oldest positions are darker)
         for (int t = 0; t < 10; t++)
         {
+            track_sprite(game.balls[i].trail_x[t], game.balls[i].trail_y[t], 1, 1);
+
             // Calculate fade color (older = darker)
             int alpha = t * 2;
             if (alpha > 8) alpha = 8;
@@ -193,6 +347,7 @@ void draw_balls()
         }
         
         // Draw main ball (white with yellow highlight)
+        track_sprite(game.balls[i].x, game.balls[i].y, BALL_SIZE, BALL_SIZE);
         draw_rect(game.balls[i].x, game.balls[i].y, BALL_SIZE, BALL_SIZE, 15);
         
         // Add highlight pixel for 3D look
@@ -218,6 +373,9 @@ void draw_paddle()
     // Different color per player
     uint8_t color = (game.current_player == 0) ? 15 : 11;  // White or cyan
     
+    // Paddle plus the laser indicators above it
+    track_sprite(player->paddle_x, PADDLE_Y - 3, player->paddle_width, PADDLE_HEIGHT + 3);
+    
     // Draw paddle rectangle
     draw_rect(player->paddle_x, PADDLE_Y, player->paddle_width, PADDLE_HEIGHT, color);
     
@@ -265,26 +423,18 @@ void draw_powerups()
         uint8_t color = powerup_colors[game.powerups[i].type];
         
         // Draw power-up box
+        track_sprite(game.powerups[i].x, game.powerups[i].y, POWERUP_SIZE, POWERUP_SIZE);
         draw_rect(game.powerups[i].x, game.powerups[i].y, 
                  POWERUP_SIZE, POWERUP_SIZE, color);
         
         // Draw white border
-        for (int j = 0; j < POWERUP_SIZE; j++)
-        {
-            draw_pixel(game.powerups[i].x + j, game.powerups[i].y, 15);
-            draw_pixel(game.powerups[i].x + j, game.powerups[i].y + POWERUP_SIZE - 1, 15);
-            draw_pixel(game.powerups[i].x, game.powerups[i].y + j, 15);
-            draw_pixel(game.powerups[i].x + POWERUP_SIZE - 1, game.powerups[i].y + j, 15);
-        }
+        draw_outline(game.powerups[i].x, game.powerups[i].y, POWERUP_SIZE, POWERUP_SIZE, 1, 15);
         
         // Draw simple icon (black cross in center)
         int cx = game.powerups[i].x + POWERUP_SIZE / 2;
         int cy = game.powerups[i].y + POWERUP_SIZE / 2;
-        draw_pixel(cx, cy, 0);
-        draw_pixel(cx - 1, cy, 0);
-        draw_pixel(cx + 1, cy, 0);
-        draw_pixel(cx, cy - 1, 0);
-        draw_pixel(cx, cy + 1, 0);
+        draw_rect(cx - 1, cy, 3, 1, 0);
+        draw_rect(cx, cy - 1, 1, 3, 0);
     }
 }
 
@@ -308,6 +458,7 @@ void draw_lasers()
         }
         
         // Draw laser beam (2 pixels wide, 5 pixels tall)
+        track_sprite(game.lasers[i].x, game.lasers[i].y, 2, 5);
         draw_rect(game.lasers[i].x, game.lasers[i].y, 2, 5, 10);  // Light green
         draw_rect(game.lasers[i].x, game.lasers[i].y, 1, 5, 15);  // White core
     }
@@ -340,7 +491,7 @@ void draw_particles()
         }
         
         // Draw particle (2 pixels for visibility)
-        draw_pixel(game.particles[i].x, game.particles[i].y, color);
-        draw_pixel(game.particles[i].x + 1, game.particles[i].y, color);
+        track_sprite(game.particles[i].x, game.particles[i].y, 2, 1);
+        draw_rect(game.particles[i].x, game.particles[i].y, 2, 1, color);
     }
 }
\ No newline at end of file
@@ -1,279 +1,107 @@
 /*
- * breakout_main.c - Main game logic (SIMPLIFIED)
+ * breakout_main.c - Main game loop (SIMPLIFIED)
+ *
+ * Runs the game from breakout_game.c against the real keyboard, timer and
+ * screen: input, screens between levels, frame pacing and telemetry.
  */
 
 #include "keyboard/keyboard.h"
 #include "graphics/vga.h"
 #include "timer/timer.h"
+#include "timer/frame_pacer.h"
+#include "timer/profiler.h"
+#include "telemetry/telemetry.h"
+#include "serial/serial.h"
+#include "memory/heap/kheap.h"
 #include "breakout.h"
 
-/* GLOBAL GAME STATE */
-game_state_t game;
+// External references
+extern game_state_t game;
 
-/* LEVEL DEFINITIONS */
-level_t levels[MAX_LEVELS] = {
-    // LEVEL 1: CLASSIC
-    {
-        .pattern = {
-            {1,1,1,1,1,1,1,1,1,1,1,1},
-            {1,1,1,1,1,1,1,1,1,1,1,1},
-            {1,1,1,1,1,1,1,1,1,1,1,1},
-            {1,1,1,1,1,1,1,1,1,1,1,1},
-            {1,1,1,1,1,1,1,1,1,1,1,1}
-        },
-        .colors = {4, 12, 14, 2, 1},
-        .ball_speed = 2,
-        .name = "CLASSIC"
-    },
-    
-    // LEVEL 2: CHECKERBOARD
-    {
-        .pattern = {
-            {2,0,2,0,2,0,2,0,2,0,2,0},
-            {0,2,0,2,0,2,0,2,0,2,0,2},
-            {2,0,2,0,2,0,2,0,2,0,2,0},
-            {0,2,0,2,0,2,0,2,0,2,0,2},
-            {2,0,2,0,2,0,2,0,2,0,2,0}
-        },
-        .colors = {12, 12, 14, 14, 2},
-        .ball_speed = 3,
-        .name = "CHECKERBOARD"
-    },
-    
-    // LEVEL 3: PYRAMID
-    {
-        .pattern = {
-            {0,0,0,0,0,3,3,0,0,0,0,0},
-            {0,0,0,0,2,2,2,2,0,0,0,0},
-            {0,0,0,2,2,2,2,2,2,0,0,0},
-            {0,0,2,2,2,2,2,2,2,2,0,0},
-            {0,2,2,2,2,2,2,2,2,2,2,0}
-        },
-        .colors = {4, 12, 14, 2, 1},
-        .ball_speed = 3,
-        .name = "PYRAMID"
-    },
-    
-    // LEVEL 4: BOSS
-    {
-        .pattern = {
-            {3,3,3,3,3,3,3,3,3,3,3,3},
-            {3,0,0,3,3,3,3,3,3,0,0,3},
-            {3,3,3,3,3,3,3,3,3,3,3,3},
-            {3,0,0,3,3,3,3,3,3,0,0,3},
-            {3,3,3,3,3,3,3,3,3,3,3,3}
-        },
-        .colors = {4, 4, 12, 12, 14},
-        .ball_speed = 4,
-        .name = "BOSS"
-    }
+/* PROFILER STAGE NAMES (same order as profiler_stage_t) */
+static const char* profiler_stage_names[PROF_STAGE_COUNT] = {
+    "FRAME",
+    "UPD BALLS", "UPD BRICKS", "UPD POWER", "UPD PARTS", "UPD LASERS",
+    "BEGIN",
+    "DRW BRICKS", "DRW PADDLE", "DRW BALLS", "DRW POWER", "DRW LASERS", "DRW PARTS", "DRW HUD",
+    "PRESENT"
 };
 
-/* EXTERNAL FUNCTION DECLARATIONS */
-extern void init_bricks();
-extern void init_balls();
-extern void update_balls();
-extern void update_bricks();
-extern bool check_level_complete();
-extern void update_powerups();
-extern void update_particles();
-extern void draw_rect(int x, int y, int width, int height, uint8_t color);
-extern void draw_bricks();
-extern void draw_balls();
-extern void draw_paddle();
-extern void draw_powerups();
-extern void draw_lasers();
-extern void draw_particles();
-extern void draw_hud();
-extern void draw_level_start_screen();
-extern void draw_turn_transition();
-extern void draw_winner_screen();
-extern void draw_countdown(int number);
-
-void shoot_laser(player_t* player);
-void update_lasers();
-
-/* LASER SYSTEM */
-void shoot_laser(player_t* player)
+/*
+ * show_profiler_dump - Full statistics table until a key is pressed
+ */
+static void show_profiler_dump()
 {
-    if (!player->has_laser || player->laser_cooldown > 0)
-    {
-        return;
-    }
+    draw_profiler_dump();
+    vga_present();
     
-    for (int i = 0; i < MAX_LASERS; i++)
+    key_event_t event;
+    while (1)
     {
-        if (!game.lasers[i].active)
+        if (keyboard_get_event(&event) && event.pressed)
         {
-            game.lasers[i].x = player->paddle_x + player->paddle_width / 2;
-            game.lasers[i].y = PADDLE_Y - 5;
-            game.lasers[i].active = true;
-            player->laser_cooldown = 10;
-            return;
+            break;
         }
     }
-}
-
-void update_lasers()
-{
-    player_t* player = &game.players[game.current_player];
-    
-    if (player->laser_cooldown > 0)
-    {
-        player->laser_cooldown--;
-    }
     
-    for (int i = 0; i < MAX_LASERS; i++)
-    {
-        if (!game.lasers[i].active)
-        {
-            continue;
-        }
-        
-        game.lasers[i].y -= 5;
-        
-        for (int row = 0; row < BRICK_ROWS; row++)
-        {
-            for (int col = 0; col < BRICK_COLS; col++)
-            {
-                if (game.bricks[row][col].health == 0)
-                {
-                    continue;
-                }
-                
-                int brick_x = col * (BRICK_WIDTH + 2) + BRICK_OFFSET_X;
-                int brick_y = row * (BRICK_HEIGHT + 2) + BRICK_OFFSET_Y;
-                
-                if (game.lasers[i].x >= brick_x && 
-                    game.lasers[i].x < brick_x + BRICK_WIDTH &&
-                    game.lasers[i].y >= brick_y && 
-                    game.lasers[i].y < brick_y + BRICK_HEIGHT)
-                {
-                    game.bricks[row][col].health--;
-                    game.lasers[i].active = false;
-                    
-                    if (game.bricks[row][col].health == 0)
-                    {
-                        player->score += 10;
-                        extern void spawn_explosion(int x, int y, uint8_t color);
-                        extern void spawn_powerup(int x, int y);
-                        spawn_explosion(brick_x + BRICK_WIDTH/2, brick_y + BRICK_HEIGHT/2,
-                                      levels[game.level].colors[row]);
-                        spawn_powerup(brick_x, brick_y);
-                        game.screen_shake_timer = 3;
-                    }
-                    
-                    goto next_laser;
-                }
-            }
-        }
-        
-        next_laser:
-        
-        if (game.lasers[i].y < 0)
-        {
-            game.lasers[i].active = false;
-        }
-    }
+    render_invalidate();
 }
 
-/* INPUT HANDLING */
-static void handle_input(key_event_t* event)
-{
-    if (!event->pressed)
-    {
-        return;
-    }
-    
-    if (game.all_players_done)
-    {
-        if (event->scancode == 0x39)  // Space
-        {
-            breakout_init(game.num_players);
-        }
-        return;
-    }
-    
-    player_t* player = &game.players[game.current_player];
-    
-    // Left
-    if (event->scancode == 0x4B || event->scancode == 0x1E)
-    {
-        player->paddle_x -= PADDLE_SPEED * 2;
-        if (player->paddle_x < 0)
-        {
-            player->paddle_x = 0;
-        }
-    }
-    
-    // Right
-    if (event->scancode == 0x4D || event->scancode == 0x20)
-    {
-        player->paddle_x += PADDLE_SPEED * 2;
-        if (player->paddle_x > VGA_WIDTH - player->paddle_width)
-        {
-            player->paddle_x = VGA_WIDTH - player->paddle_width;
-        }
-    }
-    
-    // Shoot laser
-    if (event->scancode == 0x1D)
-    {
-        shoot_laser(player);
-    }
-}
+/* TELEMETRY */
+
+// Frames between periodic summaries on COM1 (~10 s)
+#define TELEMETRY_SUMMARY_FRAMES 600
+
+static TELEMETRY_COUNTER(frames_presented, "game.frames");
 
-/* GAME INITIALIZATION - SIMPLIFIED */
-void breakout_init(int num_players)
+/*
+ * publish_summary - Periodic frame, counter and heap statistics over COM1
+ */
+static void publish_summary(struct frame_pacer* pacer, struct telemetry_histogram* frame_hist)
 {
-    game.num_players = (num_players <= MAX_PLAYERS) ? num_players : 1;
-    game.current_player = 0;
-    game.level = 0;
-    game.all_players_done = false;
-    
-    game.music_note = 0;
-    game.music_timer = 0;
-    game.screen_shake_timer = 0;
-    game.screen_shake_x = 0;
-    game.screen_shake_y = 0;
-    
-    // Initialize both players - FIXED VALUES
-    for (int p = 0; p < MAX_PLAYERS; p++)
-    {
-        game.players[p].lives = 3;  // Fixed: 3 lives
-        game.players[p].score = 0;
-        game.players[p].paddle_width = PADDLE_WIDTH;  // Fixed: 40px
-        game.players[p].paddle_x = VGA_WIDTH / 2 - game.players[p].paddle_width / 2;
-        game.players[p].has_laser = false;
-        game.players[p].laser_cooldown = 0;
-        game.players[p].turn_complete = false;
-        game.players[p].ball_speed_multiplier = 1.0f;
-    }
-    
-    // Deactivate all lasers
-    for (int i = 0; i < MAX_LASERS; i++)
-    {
-        game.lasers[i].active = false;
-    }
-    
-    init_bricks();
-    init_balls();
+    telemetry_publish_histogram(frame_hist);
+    telemetry_histogram_reset(frame_hist);
     
-    for (int i = 0; i < MAX_POWERUPS; i++)
-    {
-        game.powerups[i].active = false;
-    }
-    
-    for (int i = 0; i < MAX_PARTICLES; i++)
-    {
-        game.particles[i].active = false;
-    }
+    telemetry_value("pacer.avg_ms", frame_pacer_average_ms(pacer));
+    telemetry_value("pacer.jitter_ms", frame_pacer_average_jitter_ms(pacer));
+    telemetry_value("pacer.max_ms", pacer->frame_ms_max);
+    telemetry_value("pacer.dropped_steps", pacer->dropped_steps);
+    telemetry_value("serial.dropped", serial_get_dropped());
+    telemetry_publish_counters();
+    kheap_publish();
+    profiler_dump(telemetry_log);
 }
 
 /* MAIN GAME LOOP */
 void breakout_run()
 {
-    uint32_t last_update = timer_get_ticks();
+    // Simulation runs in fixed 16 ms steps; frames are presented on
+    // vertical retrace so they line up with the 70 Hz refresh. The game
+    // runs unchained so presenting is a page flip instead of a copy.
+    struct frame_pacer pacer;
+    frame_pacer_init(&pacer, 16);
+    
+    // Per-stage timings: F3 toggles the overlay, F4 shows the full table
+    profiler_init(profiler_stage_names, PROF_STAGE_COUNT);
+    bool show_profiler = false;
+    bool dump_profiler = false;
+    
+    // Frame times (1 ms buckets) and per-frame samples go out over COM1
+    struct telemetry_histogram frame_hist;
+    telemetry_histogram_init(&frame_hist, "frame_us", 1000);
+    uint32_t frame_number = 0;
+    uint32_t last_frame_cycles = timer_get_cycles();
+    telemetry_log("breakout: game loop started");
+    
+    bool old_vsync = vga_get_vsync();
+    bool old_unchained = vga_get_unchained();
+#ifdef PEACHOS_BENCHMARK
+    // Benchmark frames run flat out; retrace waits would hide their cost
+    vga_set_vsync(false);
+#else
+    vga_set_vsync(true);
+#endif
+    vga_set_unchained(true);
     
     bool showing_transition = false;
     uint32_t transition_start = 0;
@@ -294,15 +122,36 @@ void breakout_run()
     
     while (1)
     {
+#ifdef PEACHOS_BENCHMARK
+        benchmark_script_input();
+#endif
+        
         // INPUT
         key_event_t event;
         while (keyboard_get_event(&event))
         {
             if (event.pressed && event.scancode == 0x01)  // ESC
             {
+                vga_set_unchained(old_unchained);
+                vga_set_vsync(old_vsync);
+                publish_summary(&pacer, &frame_hist);
+                telemetry_log("breakout: game loop exited");
                 return;
             }
             
+            if (event.pressed && event.scancode == 0x3D)  // F3
+            {
+                show_profiler = !show_profiler;
+                render_invalidate();
+                continue;
+            }
+            
+            if (event.pressed && event.scancode == 0x3E)  // F4
+            {
+                dump_profiler = true;
+                continue;
+            }
+            
             if (event.pressed && showing_level_start)
             {
                 showing_level_start = false;
@@ -322,7 +171,7 @@ void breakout_run()
                 continue;
             }
             
-            handle_input(&event);
+            breakout_handle_key(&event);
         }
         
         uint32_t current_ticks = timer_get_ticks();
@@ -333,6 +182,7 @@ void breakout_run()
             if (!level_start_drawn)
             {
                 draw_level_start_screen();
+                vga_present();
                 level_start_drawn = true;
                 level_start_time = current_ticks;
             }
@@ -359,6 +209,7 @@ void breakout_run()
                 if (!countdown_drawn)
                 {
                     draw_countdown(3);
+                    vga_present();
                     countdown_drawn = true;
                 }
             }
@@ -372,6 +223,7 @@ void breakout_run()
                 if (!countdown_drawn)
                 {
                     draw_countdown(2);
+                    vga_present();
                     countdown_drawn = true;
                 }
             }
@@ -385,6 +237,7 @@ void breakout_run()
                 if (!countdown_drawn)
                 {
                     draw_countdown(1);
+                    vga_present();
                     countdown_drawn = true;
                 }
             }
@@ -398,13 +251,16 @@ void breakout_run()
                 if (!countdown_drawn)
                 {
                     draw_countdown(0);
+                    vga_present();
                     countdown_drawn = true;
                 }
             }
             else if (seconds >= 4)
             {
                 showing_countdown = false;
-                last_update = current_ticks;
+                frame_pacer_reset(&pacer);
+                last_frame_cycles = timer_get_cycles();
+                render_invalidate();
             }
             continue;
         }
@@ -441,6 +297,7 @@ void breakout_run()
             if (!transition_drawn)
             {
                 draw_turn_transition();
+                vga_present();
                 transition_drawn = true;
             }
             
@@ -461,64 +318,84 @@ void breakout_run()
             if (!winner_drawn)
             {
                 draw_winner_screen();
+                vga_present();
                 winner_drawn = true;
             }
             continue;
         }
         
-        // GAME UPDATE (60 FPS)
-        if (current_ticks - last_update >= 16)
+        // PROFILER TABLE (game paused while it's up)
+        if (dump_profiler)
         {
-            last_update = current_ticks;
-            
-            update_balls();
-            update_bricks();
-            update_powerups();
-            update_particles();
-            update_lasers();
-            
-            if (check_level_complete())
+            dump_profiler = false;
+            show_profiler_dump();
+            frame_pacer_reset(&pacer);
+            last_frame_cycles = timer_get_cycles();
+        }
+        
+        // GAME UPDATE (fixed 16 ms steps, ~60 per second)
+        int steps = frame_pacer_steps(&pacer);
+#ifdef PEACHOS_BENCHMARK
+        // One step per frame, however long frames take, so that every
+        // benchmark run plays the same game
+        steps = 1;
+#endif
+        
+        // Without vsync there is nothing to wait on, so only draw when the
+        // game moved. With vsync every retrace gets a (possibly empty) present.
+        if (steps == 0 && !vga_get_vsync())
+        {
+            continue;
+        }
+        
+        profiler_begin(PROF_FRAME);
+        
+        for (int step = 0; step < steps; step++)
+        {
+            // Level or turn over - the rest of this frame's steps are moot
+            if (breakout_update())
             {
-                game.level++;
-                
-                if (game.level >= MAX_LEVELS)
+                if (!game.players[game.current_player].turn_complete)
                 {
-                    game.players[game.current_player].turn_complete = true;
-                }
-                else
-                {
-                    init_bricks();
-                    init_balls();
                     showing_level_start = true;
                     level_start_drawn = false;
                     showing_countdown = false;
                     countdown_number = 3;
                 }
+                break;
             }
-            
-            // Screen shake
-            if (game.screen_shake_timer > 0)
-            {
-                game.screen_shake_timer--;
-                extern int random_range(int min, int max);
-                game.screen_shake_x = random_range(-2, 2);
-                game.screen_shake_y = random_range(-2, 2);
-            }
-            else
-            {
-                game.screen_shake_x = 0;
-                game.screen_shake_y = 0;
-            }
-            
-            // RENDER
-            vga_clear(0);
-            draw_bricks();
-            draw_paddle();
-            draw_balls();
-            draw_powerups();
-            draw_lasers();
-            draw_particles();
-            draw_hud();
         }
+        
+        // RENDER (only what changed since the last frame)
+        breakout_render();
+        if (show_profiler)
+        {
+            draw_profiler_overlay();
+        }
+        PROFILE(PROF_PRESENT, vga_present());
+        profiler_end(PROF_FRAME);
+        profiler_end_frame();
+        frame_pacer_frame_done(&pacer);
+        
+        // Time since the previous present, as seen on screen
+        uint32_t now_cycles = timer_get_cycles();
+        uint32_t frame_us = timer_cycles_to_us(now_cycles - last_frame_cycles);
+        last_frame_cycles = now_cycles;
+        
+        telemetry_count(&frames_presented, 1);
+        telemetry_frame(frame_number, frame_us);
+        telemetry_histogram_add(&frame_hist, frame_us);
+        if (++frame_number % TELEMETRY_SUMMARY_FRAMES == 0)
+        {
+            publish_summary(&pacer, &frame_hist);
+        }
+        
+#ifdef PEACHOS_BENCHMARK
+        if (benchmark_frame_done(frame_us))
+        {
+            publish_summary(&pacer, &frame_hist);
+            benchmark_finish(BENCHMARK_STATUS_OK);
+        }
+#endif
     }
 }
\ No newline at end of file
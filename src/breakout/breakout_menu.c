@@ -7,227 +7,29 @@
 
 #include "keyboard/keyboard.h"
 #include "graphics/vga.h"
+#include "graphics/font.h"
 #include "timer/timer.h"
 #include "breakout_menu.h"
 
-// External function we need
+// External functions we need
 extern void vga_fill_rect(int x, int y, int width, int height, uint8_t color);
+extern void vga_outline_rect(int x, int y, int width, int height, int thickness, uint8_t color);
 
 // Menu state
 static menu_state_t menu;
 
 /* ============================================================================
- * SIMPLE PIXEL FONT FOR MENU TEXT
+ * MENU TEXT
  * ============================================================================
- * Drawing letters pixel by pixel for a retro look!
+ * Letters come from the shared bitmap font in graphics/font.c.
  */
 
 /*
- * draw_letter - Draw a single letter in pixel art style
- * 
- * This draws simple block letters. Not fancy, but readable!
- */
-static void draw_letter(int x, int y, char letter, uint8_t color)
-{
-    // Make letter uppercase
-    if (letter >= 'a' && letter <= 'z')
-    {
-        letter = letter - 32;
-    }
-    
-    switch (letter)
-    {
-        case '1':
-            vga_fill_rect(x + 2, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            vga_fill_rect(x, y, 2, 3, color);
-            break;
-            
-        case '2':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 4, y, 2, 5, color);
-            vga_fill_rect(x, y + 4, 6, 2, color);
-            vga_fill_rect(x, y + 6, 2, 4, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case '3':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case '4':
-            vga_fill_rect(x, y, 2, 6, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'A':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 6, 6, 2, color);
-            break;
-            
-        case 'B':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 5, 2, color);
-            vga_fill_rect(x, y + 5, 5, 2, color);
-            vga_fill_rect(x, y + 10, 5, 2, color);
-            vga_fill_rect(x + 4, y, 2, 5, color);
-            vga_fill_rect(x + 4, y + 6, 2, 4, color);
-            break;
-            
-        case 'C':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'D':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 5, 2, color);
-            vga_fill_rect(x, y + 10, 5, 2, color);
-            vga_fill_rect(x + 4, y + 2, 2, 8, color);
-            break;
-            
-        case 'E':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y + 5, 5, 2, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'G':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            vga_fill_rect(x + 4, y + 6, 2, 6, color);
-            vga_fill_rect(x + 3, y + 6, 3, 2, color);
-            break;
-            
-        case 'H':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'I':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 2, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'K':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 4, y, 2, 4, color);
-            vga_fill_rect(x + 2, y + 5, 2, 2, color);
-            vga_fill_rect(x + 4, y + 8, 2, 4, color);
-            break;
-            
-        case 'L':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'M':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 5, y, 2, 12, color);
-            vga_fill_rect(x + 2, y + 2, 1, 3, color);
-            vga_fill_rect(x + 4, y + 2, 1, 3, color);
-            break;
-            
-        case 'N':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 5, y, 2, 12, color);
-            vga_fill_rect(x + 1, y + 3, 2, 2, color);
-            vga_fill_rect(x + 2, y + 5, 2, 2, color);
-            vga_fill_rect(x + 3, y + 7, 2, 2, color);
-            break;
-            
-        case 'O':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x + 4, y, 2, 12, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'P':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 4, y, 2, 6, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'R':
-            vga_fill_rect(x, y, 2, 12, color);
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x + 4, y, 2, 6, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            vga_fill_rect(x + 4, y + 7, 2, 5, color);
-            break;
-            
-        case 'S':
-            vga_fill_rect(x, y, 6, 2, color);
-            vga_fill_rect(x, y, 2, 6, color);
-            vga_fill_rect(x, y + 5, 6, 2, color);
-            vga_fill_rect(x + 4, y + 6, 2, 4, color);
-            vga_fill_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'T':
-            vga_fill_rect(x, y, 8, 2, color);
-            vga_fill_rect(x + 3, y, 2, 12, color);
-            break;
-            
-        case 'V':
-            vga_fill_rect(x, y, 2, 8, color);
-            vga_fill_rect(x + 5, y, 2, 8, color);
-            vga_fill_rect(x + 1, y + 8, 2, 2, color);
-            vga_fill_rect(x + 4, y + 8, 2, 2, color);
-            vga_fill_rect(x + 2, y + 10, 2, 2, color);
-            break;
-            
-        case 'X':
-            vga_fill_rect(x, y, 2, 4, color);
-            vga_fill_rect(x + 4, y, 2, 4, color);
-            vga_fill_rect(x + 2, y + 4, 2, 4, color);
-            vga_fill_rect(x, y + 8, 2, 4, color);
-            vga_fill_rect(x + 4, y + 8, 2, 4, color);
-            break;
-            
-        case 'Y':
-            vga_fill_rect(x, y, 2, 6, color);
-            vga_fill_rect(x + 4, y, 2, 6, color);
-            vga_fill_rect(x + 1, y + 5, 4, 2, color);
-            vga_fill_rect(x + 2, y + 6, 2, 6, color);
-            break;
-            
-        case ' ':
-            // Space - do nothing
-            break;
-            
-        default:
-            // Unknown character - draw a small dot
-            vga_fill_rect(x + 2, y + 5, 2, 2, color);
-            break;
-    }
-}
-
-/*
- * draw_text - Draw a string of text
+ * draw_text - Draw a string of text (8 pixels per character)
  */
 static void draw_text(int x, int y, const char* text, uint8_t color)
 {
-    int cursor_x = x;
-    
-    for (int i = 0; text[i] != '\0'; i++)
-    {
-        draw_letter(cursor_x, y, text[i], color);
-        cursor_x += 8;  // Move to next character position
-    }
+    font_draw_text(&font_block, x, y, text, 1, color);
 }
 
 /* ============================================================================
@@ -355,17 +157,7 @@ static void draw_animated_bricks()
         if (y >= 0 && y < 180)
         {
             vga_fill_rect(x, y, 25, 10, brick_colors[i]);
-            
-            for (int j = 0; j < 25; j++)
-            {
-                vga_set_pixel(x + j, y, 0);
-                vga_set_pixel(x + j, y + 9, 0);
-            }
-            for (int j = 0; j < 10; j++)
-            {
-                vga_set_pixel(x, y + j, 0);
-                vga_set_pixel(x + 24, y + j, 0);
-            }
+            vga_outline_rect(x, y, 25, 10, 1, 0);
         }
     }
 }
@@ -502,6 +294,7 @@ int menu_run()
             last_update = current_ticks;
             menu.animation_frame++;
             menu_show();
+            vga_present();
         }
     }
     
@@ -19,6 +19,20 @@
 // External references
 extern game_state_t game;
 
+// Generator state shared by random_range() and random_seed()
+static uint32_t random_state = 12345;
+
+/*
+ * random_seed - Restart the random sequence from a known value
+ * 
+ * The game always starts from the same seed anyway; the benchmark calls
+ * this so that every run replays exactly the same game.
+ */
+void random_seed(uint32_t seed)
+{
+    random_state = seed & 0x7FFFFFFF;
+}
+
 /*
  * random_range - Generate a pseudo-random number
  * 
@@ -35,15 +49,12 @@ extern game_state_t game;
  */
 int random_range(int min, int max)
 {
-    // Static variable persists between function calls
-    static uint32_t seed = 12345;
-    
     // LCG formula: seed = (a * seed + c) mod m
     // These constants are from Numerical Recipes
-    seed = (seed * 1103515245 + 12345) & 0x7FFFFFFF;
+    random_state = (random_state * 1103515245 + 12345) & 0x7FFFFFFF;
     
     // Map to our desired range
-    return min + (seed % (max - min + 1));
+    return min + (random_state % (max - min + 1));
 }
 
 /*
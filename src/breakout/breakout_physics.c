@@ -277,6 +277,7 @@ void update_balls()
                 {
                     // Hit a brick! Damage it
                     game.bricks[row][col].health--;
+                    brick_layer_update(row, col);
                     
                     // Bounce ball
                     game.balls[i].dy = -game.balls[i].dy;
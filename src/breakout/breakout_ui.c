@@ -8,12 +8,14 @@
  * - Winner/game over screen
  * - Text and number rendering
  * 
- * These screens use simple pixel art for text since we don't have a font library!
+ * Text is drawn with the small bitmap font in graphics/font.c.
  */
 
 #include "keyboard/keyboard.h"
 #include "graphics/vga.h"
+#include "graphics/font.h"
 #include "timer/timer.h"
+#include "timer/profiler.h"
 #include "breakout.h"
 
 // External references
@@ -21,277 +23,20 @@ extern game_state_t game;
 extern level_t levels[MAX_LEVELS];
 extern void draw_rect(int x, int y, int width, int height, uint8_t color);
 extern void draw_pixel(int x, int y, uint8_t color);
+extern void draw_outline(int x, int y, int width, int height, int thickness, uint8_t color);
 
 /* ============================================================================
- * SIMPLE PIXEL FONT FOR TEXT RENDERING
+ * TEXT RENDERING
  * ============================================================================
- * Drawing letters pixel by pixel for a retro look!
+ * Letters come from the shared bitmap font in graphics/font.c.
  */
 
 /*
- * draw_letter - Draw a single letter in pixel art style
- * 
- * This draws simple block letters. Not fancy, but readable!
- */
-static void draw_letter(int x, int y, char letter, uint8_t color)
-{
-    // Make letter uppercase
-    if (letter >= 'a' && letter <= 'z')
-    {
-        letter = letter - 32;
-    }
-    
-    switch (letter)
-    {
-        case '1':
-            draw_rect(x + 2, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            draw_rect(x, y, 2, 3, color);
-            break;
-            
-        case '2':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 4, y, 2, 5, color);
-            draw_rect(x, y + 4, 6, 2, color);
-            draw_rect(x, y + 6, 2, 4, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case '3':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case '4':
-            draw_rect(x, y, 2, 6, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'A':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 6, 6, 2, color);
-            break;
-            
-        case 'B':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 5, 2, color);
-            draw_rect(x, y + 5, 5, 2, color);
-            draw_rect(x, y + 10, 5, 2, color);
-            draw_rect(x + 4, y, 2, 5, color);
-            draw_rect(x + 4, y + 6, 2, 4, color);
-            break;
-            
-        case 'C':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'D':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 5, 2, color);
-            draw_rect(x, y + 10, 5, 2, color);
-            draw_rect(x + 4, y + 2, 2, 8, color);
-            break;
-            
-        case 'E':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y + 5, 5, 2, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'G':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            draw_rect(x + 4, y + 6, 2, 6, color);
-            draw_rect(x + 3, y + 6, 3, 2, color);
-            break;
-            
-        case 'H':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'I':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 2, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'K':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 4, y, 2, 4, color);
-            draw_rect(x + 2, y + 5, 2, 2, color);
-            draw_rect(x + 4, y + 8, 2, 4, color);
-            break;
-            
-        case 'L':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'M':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 5, y, 2, 12, color);
-            draw_rect(x + 2, y + 2, 1, 3, color);
-            draw_rect(x + 4, y + 2, 1, 3, color);
-            break;
-            
-        case 'N':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 5, y, 2, 12, color);
-            draw_rect(x + 1, y + 3, 2, 2, color);
-            draw_rect(x + 2, y + 5, 2, 2, color);
-            draw_rect(x + 3, y + 7, 2, 2, color);
-            break;
-            
-        case 'O':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x + 4, y, 2, 12, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'P':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 4, y, 2, 6, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            break;
-            
-        case 'R':
-            draw_rect(x, y, 2, 12, color);
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x + 4, y, 2, 6, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            draw_rect(x + 4, y + 7, 2, 5, color);
-            break;
-            
-        case 'S':
-            draw_rect(x, y, 6, 2, color);
-            draw_rect(x, y, 2, 6, color);
-            draw_rect(x, y + 5, 6, 2, color);
-            draw_rect(x + 4, y + 6, 2, 4, color);
-            draw_rect(x, y + 10, 6, 2, color);
-            break;
-            
-        case 'T':
-            draw_rect(x, y, 8, 2, color);
-            draw_rect(x + 3, y, 2, 12, color);
-            break;
-            
-        case 'V':
-            draw_rect(x, y, 2, 8, color);
-            draw_rect(x + 5, y, 2, 8, color);
-            draw_rect(x + 1, y + 8, 2, 2, color);
-            draw_rect(x + 4, y + 8, 2, 2, color);
-            draw_rect(x + 2, y + 10, 2, 2, color);
-            break;
-            
-        case 'X':
-            draw_rect(x, y, 2, 4, color);
-            draw_rect(x + 4, y, 2, 4, color);
-            draw_rect(x + 2, y + 4, 2, 4, color);
-            draw_rect(x, y + 8, 2, 4, color);
-            draw_rect(x + 4, y + 8, 2, 4, color);
-            break;
-            
-        case 'Y':
-            draw_rect(x, y, 2, 6, color);
-            draw_rect(x + 4, y, 2, 6, color);
-            draw_rect(x + 1, y + 5, 4, 2, color);
-            draw_rect(x + 2, y + 6, 2, 6, color);
-            break;
-            
-        case ' ':
-            // Space - do nothing
-            break;
-            
-        default:
-            // Unknown character - draw a small dot
-            draw_rect(x + 2, y + 5, 2, 2, color);
-            break;
-    }
-}
-
-/*
- * draw_text - Draw a string of text
+ * draw_text - Draw a string of text (8 pixels per character)
  */
 static void draw_text(int x, int y, const char* text, uint8_t color)
 {
-    int cursor_x = x;
-    
-    for (int i = 0; text[i] != '\0'; i++)
-    {
-        draw_letter(cursor_x, y, text[i], color);
-        cursor_x += 8;  // Move to next character position
-    }
-}
-
-/* ============================================================================
- * DIGIT FONT SYSTEM
- * ============================================================================
- * We need to draw numbers for scores and lives. This is a simple 5x7 pixel
- * font for digits 0-9.
- */
-
-/*
- * digit_font - 5x7 pixel representation of digits 0-9
- * 
- * Each digit is 7 rows tall. Each row is a byte where bits represent pixels.
- * Bit 4 = leftmost pixel, bit 0 = rightmost pixel.
- */
-static const uint8_t digit_font[10][7] = {
-    {0x1F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1F},  // 0
-    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x1F},  // 1
-    {0x1F, 0x01, 0x01, 0x1F, 0x10, 0x10, 0x1F},  // 2
-    {0x1F, 0x01, 0x01, 0x1F, 0x01, 0x01, 0x1F},  // 3
-    {0x11, 0x11, 0x11, 0x1F, 0x01, 0x01, 0x01},  // 4
-    {0x1F, 0x10, 0x10, 0x1F, 0x01, 0x01, 0x1F},  // 5
-    {0x1F, 0x10, 0x10, 0x1F, 0x11, 0x11, 0x1F},  // 6
-    {0x1F, 0x01, 0x01, 0x02, 0x04, 0x08, 0x10},  // 7
-    {0x1F, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x1F},  // 8
-    {0x1F, 0x11, 0x11, 0x1F, 0x01, 0x01, 0x1F},  // 9
-};
-
-/*
- * draw_digit - Draw a single digit
- * 
- * Parameters:
- *   x, y - Top-left position
- *   digit - Which digit (0-9)
- *   color - VGA color to use
- */
-static void draw_digit(int x, int y, int digit, uint8_t color)
-{
-    if (digit < 0 || digit > 9)
-    {
-        return;  // Invalid digit
-    }
-    
-    // Draw each row of the digit
-    for (int row = 0; row < 7; row++)
-    {
-        uint8_t line = digit_font[digit][row];
-        
-        // Draw each pixel in the row
-        for (int col = 0; col < 5; col++)
-        {
-            // Check if this bit is set
-            if (line & (1 << (4 - col)))
-            {
-                vga_set_pixel(x + col, y + row, color);
-            }
-        }
-    }
+    font_draw_text(&font_block, x + game.screen_shake_x, y + game.screen_shake_y, text, 1, color);
 }
 
 /*
@@ -335,7 +80,7 @@ static void draw_number(int x, int y, int number, uint8_t color)
     // Draw digits from right to left
     for (int i = 0; i < num_digits; i++)
     {
-        draw_digit(x - (i * 6), y, digits[i], color);
+        font_draw_char(&font_digits, x - (i * 6), y, '0' + digits[i], 1, color);
     }
 }
 
@@ -344,6 +89,33 @@ static void draw_number(int x, int y, int number, uint8_t color)
  * ============================================================================
  */
 
+// HUD screen areas: top strip (player, score, level) and bottom strip (lives)
+#define HUD_TOP_HEIGHT 20
+#define HUD_BOTTOM_Y (VGA_HEIGHT - 11)
+
+// What the HUD currently on screen shows, so unchanged frames can skip it
+static bool hud_valid = false;
+static int hud_player = -1;
+static int hud_score = -1;
+static int hud_lives = -1;
+static int hud_level = -1;
+
+/*
+ * invalidate_hud - Force the HUD to be redrawn next frame
+ */
+void invalidate_hud()
+{
+    hud_valid = false;
+}
+
+/*
+ * hud_overlaps - Does a screen area intersect the HUD strips?
+ */
+bool hud_overlaps(int x, int y, int width, int height)
+{
+    return y < HUD_TOP_HEIGHT || y + height > HUD_BOTTOM_Y;
+}
+
 /*
  * draw_hud - Draw the game HUD at the top of the screen
  * 
@@ -352,16 +124,35 @@ static void draw_number(int x, int y, int number, uint8_t color)
  * - Score
  * - Lives (as heart shapes)
  * - Current level
+ * 
+ * Skipped entirely when nothing it shows has changed.
  */
 void draw_hud()
 {
     player_t* player = &game.players[game.current_player];
     
+    if (hud_valid &&
+        hud_player == game.current_player &&
+        hud_score == player->score &&
+        hud_lives == player->lives &&
+        hud_level == game.level)
+    {
+        return;
+    }
+    
+    hud_valid = true;
+    hud_player = game.current_player;
+    hud_score = player->score;
+    hud_lives = player->lives;
+    hud_level = game.level;
+    
     // Player indicator color (yellow for P1, cyan for P2)
     uint8_t player_color = (game.current_player == 0) ? 14 : 11;
     
-    // Clear HUD area
+    // Clear HUD areas (hearts and level digits can shrink)
     draw_rect(5, 5, 80, 12, 0);
+    draw_rect(VGA_WIDTH - 40, 5, 35, 12, 0);
+    draw_rect(10, VGA_HEIGHT - 10, 60, 6, 0);
     
     // Draw "P1" or "P2" text (simple pixel art)
     // P
@@ -445,83 +236,26 @@ void draw_countdown(int number)
     
     if (number >= 1 && number <= 3)
     {
-        // Draw large digit (40x60 pixels)
+        // Large digit in a 40x60 box
         int digit = number;
         int x = center_x - 20;
         int y = center_y - 30;
         
-        // Draw the digit based on which number
-        switch (digit)
-        {
-            case 3:
-                // Draw "3"
-                draw_rect(x, y, 40, 8, color);           // Top bar
-                draw_rect(x + 32, y, 8, 28, color);      // Right side top
-                draw_rect(x, y + 26, 40, 8, color);      // Middle bar
-                draw_rect(x + 32, y + 32, 8, 28, color); // Right side bottom
-                draw_rect(x, y + 52, 40, 8, color);      // Bottom bar
-                break;
-                
-            case 2:
-                // Draw "2"
-                draw_rect(x, y, 40, 8, color);           // Top bar
-                draw_rect(x + 32, y, 8, 28, color);      // Right side top
-                draw_rect(x, y + 26, 40, 8, color);      // Middle bar
-                draw_rect(x, y + 32, 8, 28, color);      // Left side bottom
-                draw_rect(x, y + 52, 40, 8, color);      // Bottom bar
-                break;
-                
-            case 1:
-                // Draw "1"
-                draw_rect(x, y, 20, 8, color);           // Top angle
-                draw_rect(x + 16, y, 8, 60, color);      // Vertical bar
-                draw_rect(x, y + 52, 40, 8, color);      // Bottom bar
-                break;
-        }
+        // Block font digit blown up 5x (30x60), centered in the box
+        font_draw_char(&font_block, x + 5 + game.screen_shake_x, y + game.screen_shake_y,
+                       '0' + digit, 5, color);
         
-        // Draw glowing border effect
-        for (int i = 0; i < 3; i++)
-        {
-            // Top
-            for (int dx = -5 - i; dx < 45 + i; dx++)
-                draw_pixel(x + dx, y - 5 - i, color - 4);
-            // Bottom
-            for (int dx = -5 - i; dx < 45 + i; dx++)
-                draw_pixel(x + dx, y + 65 + i, color - 4);
-            // Left
-            for (int dy = -5 - i; dy < 65 + i; dy++)
-                draw_pixel(x - 5 - i, y + dy, color - 4);
-            // Right
-            for (int dy = -5 - i; dy < 65 + i; dy++)
-                draw_pixel(x + 45 + i, y + dy, color - 4);
-        }
+        // Draw glowing border effect (3 pixels thick)
+        draw_outline(x - 7, y - 7, 55, 75, 3, color - 4);
     }
     else
     {
-        // Draw "GO!" text (bigger and clearer)
+        // Draw "GO!" text, block font blown up 4x (32 pixels per letter)
         int x = center_x - 40;
-        int y = center_y - 25;
-        
-        // G (larger)
-        draw_rect(x, y, 25, 8, color);          // Top
-        draw_rect(x, y, 8, 50, color);          // Left side
-        draw_rect(x, y + 42, 25, 8, color);     // Bottom
-        draw_rect(x + 17, y + 25, 8, 25, color);// Right side bottom
-        draw_rect(x + 12, y + 25, 13, 8, color);// Inner horizontal
-        
-        x += 35;
-        
-        // O (larger)
-        draw_rect(x, y, 25, 8, color);          // Top
-        draw_rect(x, y, 8, 50, color);          // Left side
-        draw_rect(x + 17, y, 8, 50, color);     // Right side
-        draw_rect(x, y + 42, 25, 8, color);     // Bottom
-        
-        x += 35;
+        int y = center_y - 24;
         
-        // ! (larger)
-        draw_rect(x + 6, y, 8, 35, color);      // Vertical
-        draw_rect(x + 6, y + 40, 8, 10, color); // Dot
+        font_draw_text(&font_block, x + game.screen_shake_x, y + game.screen_shake_y,
+                       text, 4, color);
         
         // Draw border around GO!
         int border_x = center_x - 50;
@@ -530,19 +264,7 @@ void draw_countdown(int number)
         int border_h = 70;
         
         // Thick white border
-        for (int i = 0; i < 4; i++)
-        {
-            for (int j = 0; j < border_w; j++)
-            {
-                draw_pixel(border_x + j, border_y + i, 15);
-                draw_pixel(border_x + j, border_y + border_h - 1 - i, 15);
-            }
-            for (int j = 0; j < border_h; j++)
-            {
-                draw_pixel(border_x + i, border_y + j, 15);
-                draw_pixel(border_x + border_w - 1 - i, border_y + j, 15);
-            }
-        }
+        draw_outline(border_x, border_y, border_w, border_h, 4, 15);
         
         // Pulse effect rings
         for (int i = 1; i <= 3; i++)
@@ -550,18 +272,8 @@ void draw_countdown(int number)
             int offset = i * 10;
             uint8_t ring_color = 10 - (i * 2);
             
-            // Top
-            for (int j = 0; j < border_w + offset * 2; j++)
-                draw_pixel(border_x - offset + j, border_y - offset, ring_color);
-            // Bottom
-            for (int j = 0; j < border_w + offset * 2; j++)
-                draw_pixel(border_x - offset + j, border_y + border_h + offset - 1, ring_color);
-            // Left
-            for (int j = 0; j < border_h + offset * 2; j++)
-                draw_pixel(border_x - offset, border_y - offset + j, ring_color);
-            // Right
-            for (int j = 0; j < border_h + offset * 2; j++)
-                draw_pixel(border_x + border_w + offset - 1, border_y - offset + j, ring_color);
+            draw_outline(border_x - offset, border_y - offset,
+                         border_w + offset * 2, border_h + offset * 2, 1, ring_color);
         }
     }
 }
@@ -594,20 +306,7 @@ void draw_level_start_screen()
     draw_rect(box_x + 3, box_y + 3, box_w - 6, box_h - 6, 0);
     
     // Draw white border for emphasis
-    for (int i = 0; i < box_w; i++)
-    {
-        vga_set_pixel(box_x + i, box_y, 15);
-        vga_set_pixel(box_x + i, box_y + 1, 15);
-        vga_set_pixel(box_x + i, box_y + box_h - 1, 15);
-        vga_set_pixel(box_x + i, box_y + box_h - 2, 15);
-    }
-    for (int i = 0; i < box_h; i++)
-    {
-        vga_set_pixel(box_x, box_y + i, 15);
-        vga_set_pixel(box_x + 1, box_y + i, 15);
-        vga_set_pixel(box_x + box_w - 1, box_y + i, 15);
-        vga_set_pixel(box_x + box_w - 2, box_y + i, 15);
-    }
+    vga_outline_rect(box_x, box_y, box_w, box_h, 2, 15);
     
     int text_y = box_y + 15;
     int text_x = box_x + 20;
@@ -759,20 +458,7 @@ void draw_winner_screen()
     draw_rect(box_x, box_y, box_w, box_h, 0);
 
     // Thick border
-    for (int i = 0; i < box_w; i++)
-    {
-        vga_set_pixel(box_x + i, box_y, accent);
-        vga_set_pixel(box_x + i, box_y + 1, accent);
-        vga_set_pixel(box_x + i, box_y + box_h - 1, accent);
-        vga_set_pixel(box_x + i, box_y + box_h - 2, accent);
-    }
-    for (int i = 0; i < box_h; i++)
-    {
-        vga_set_pixel(box_x, box_y + i, accent);
-        vga_set_pixel(box_x + 1, box_y + i, accent);
-        vga_set_pixel(box_x + box_w - 1, box_y + i, accent);
-        vga_set_pixel(box_x + box_w - 2, box_y + i, accent);
-    }
+    vga_outline_rect(box_x, box_y, box_w, box_h, 2, accent);
 
     int text_y = box_y + 15;
     int text_x = box_x + 25;
@@ -819,3 +505,52 @@ void draw_winner_screen()
     text_y += 20;
     draw_text(box_x + 25, text_y, "PRESS SPACE", 8);
 }
+
+/* ============================================================================
+ * PROFILER DISPLAY
+ * ============================================================================
+ * Stage timings from timer/profiler.c, in microseconds.
+ */
+
+#define PROFILER_ROW_HEIGHT 12
+
+static int profiler_text_y;
+
+static void profiler_write_line(const char* line)
+{
+    font_draw_text(&font_block, 8, profiler_text_y, line, 1, 15);
+    profiler_text_y += PROFILER_ROW_HEIGHT;
+}
+
+/*
+ * draw_profiler_overlay - Average and p99 per stage over the play field
+ * 
+ * Drawn on top of everything every frame while enabled.
+ */
+void draw_profiler_overlay()
+{
+    char line[PROFILER_LINE_MAX];
+    int rows = profiler_stage_count() + 1;
+    
+    vga_fill_rect(0, 0, 8 + 24 * 8 + 4, 2 + rows * PROFILER_ROW_HEIGHT, 0);
+    
+    profiler_text_y = 2;
+    profiler_format_header(line, true);
+    profiler_write_line(line);
+    for (int i = 0; i < profiler_stage_count(); i++)
+    {
+        profiler_format_stage(i, line, true);
+        profiler_write_line(line);
+    }
+}
+
+/*
+ * draw_profiler_dump - Full min/avg/max/p99 table on a blank screen
+ */
+void draw_profiler_dump()
+{
+    vga_clear(0);
+    
+    profiler_text_y = 4;
+    profiler_dump(profiler_write_line);
+}
@@ -15,6 +15,26 @@
 
 #define PEACHOS_SECTOR_SIZE 512
 
+// ADDED: Sectors kept by the disk cache (0 turns it off). Reads longer than
+// PEACHOS_DISK_CACHE_BYPASS sectors are bulk data and go around it.
+#define PEACHOS_DISK_CACHE_SECTORS 128
+#define PEACHOS_DISK_CACHE_BYPASS 16
+
+// ADDED: Sectors a disk stream reads ahead for small sequential reads
+#define PEACHOS_DISK_READAHEAD_SECTORS 8
+
+// ADDED: fat16_open() maps the file's clusters to runs up front (0 leaves
+// it to the per-descriptor cursor)
+#define PEACHOS_FAT16_CLUSTER_RUNS 1
+
+// ADDED: Name lookups remembered per FAT16 volume, misses included
+#define PEACHOS_FAT16_DENTRY_CACHE 64
+
+// ADDED: Virtual addresses handed out by fmmap(). Nothing is at these
+// physical addresses; the identity map is taken back while a file is mapped.
+#define PEACHOS_FMMAP_VIRTUAL_ADDRESS 0xD0000000
+#define PEACHOS_FMMAP_SIZE 0x10000000
+
 #define PEACHOS_MAX_FILESYSTEMS 12
 #define PEACHOS_MAX_FILE_DESCRIPTORS 512
 
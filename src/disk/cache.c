@@ -0,0 +1,209 @@
+#include "cache.h"
+#include "status.h"
+#include "memory/memory.h"
+#include "memory/heap/kheap.h"
+#include "telemetry/telemetry.h"
+
+static TELEMETRY_COUNTER(disk_cache_hits, "disk.cache_hits");
+static TELEMETRY_COUNTER(disk_cache_misses, "disk.cache_misses");
+
+static int disk_cache_bucket(unsigned int lba)
+{
+    return lba % DISK_CACHE_BUCKETS;
+}
+
+static void disk_cache_lru_remove(struct disk_cache* cache, int index)
+{
+    struct disk_cache_entry* entry = &cache->entries[index];
+    if (entry->prev != -1)
+        cache->entries[entry->prev].next = entry->next;
+    else
+        cache->lru_head = entry->next;
+
+    if (entry->next != -1)
+        cache->entries[entry->next].prev = entry->prev;
+    else
+        cache->lru_tail = entry->prev;
+
+    entry->prev = -1;
+    entry->next = -1;
+}
+
+static void disk_cache_lru_push_front(struct disk_cache* cache, int index)
+{
+    struct disk_cache_entry* entry = &cache->entries[index];
+    entry->prev = -1;
+    entry->next = cache->lru_head;
+    if (cache->lru_head != -1)
+        cache->entries[cache->lru_head].prev = index;
+    else
+        cache->lru_tail = index;
+
+    cache->lru_head = index;
+}
+
+static void disk_cache_lru_push_back(struct disk_cache* cache, int index)
+{
+    struct disk_cache_entry* entry = &cache->entries[index];
+    entry->next = -1;
+    entry->prev = cache->lru_tail;
+    if (cache->lru_tail != -1)
+        cache->entries[cache->lru_tail].next = index;
+    else
+        cache->lru_head = index;
+
+    cache->lru_tail = index;
+}
+
+static void disk_cache_unhash(struct disk_cache* cache, int index)
+{
+    int* link = &cache->buckets[disk_cache_bucket(cache->entries[index].lba)];
+    while (*link != -1)
+    {
+        if (*link == index)
+        {
+            *link = cache->entries[index].hash_next;
+            break;
+        }
+        link = &cache->entries[*link].hash_next;
+    }
+    cache->entries[index].hash_next = -1;
+}
+
+static int disk_cache_find(struct disk_cache* cache, unsigned int lba)
+{
+    for (int index = cache->buckets[disk_cache_bucket(lba)]; index != -1; index = cache->entries[index].hash_next)
+    {
+        if (cache->entries[index].lba == lba)
+            return index;
+    }
+    return -1;
+}
+
+int disk_cache_init(struct disk_cache* cache, int total, int sector_size)
+{
+    int res = 0;
+
+    memset(cache, 0, sizeof(struct disk_cache));
+    if (total <= 0 || sector_size <= 0)
+    {
+        res = -EINVARG;
+        goto out;
+    }
+
+    cache->entries = kzalloc(sizeof(struct disk_cache_entry) * total);
+    cache->data = kmalloc(total * sector_size);
+    if (!cache->entries || !cache->data)
+    {
+        kfree(cache->entries);
+        kfree(cache->data);
+        cache->entries = 0;
+        cache->data = 0;
+        res = -ENOMEM;
+        goto out;
+    }
+
+    cache->total = total;
+    cache->sector_size = sector_size;
+    cache->lru_head = -1;
+    cache->lru_tail = -1;
+    disk_cache_clear(cache);
+
+out:
+    return res;
+}
+
+// Cached copy of the sector, or 0. A hit makes it the most recently used.
+void* disk_cache_lookup(struct disk_cache* cache, unsigned int lba)
+{
+    int index = disk_cache_find(cache, lba);
+    if (index == -1)
+        return 0;
+
+    disk_cache_lru_remove(cache, index);
+    disk_cache_lru_push_front(cache, index);
+
+    cache->hits++;
+    telemetry_count(&disk_cache_hits, 1);
+    return cache->data + index * cache->sector_size;
+}
+
+// Like disk_cache_lookup() but leaves the LRU order and counters alone
+bool disk_cache_contains(struct disk_cache* cache, unsigned int lba)
+{
+    return disk_cache_find(cache, lba) != -1;
+}
+
+// Store a sector just read from the disk, replacing the least recently used
+void disk_cache_insert(struct disk_cache* cache, unsigned int lba, const void* data)
+{
+    int index = disk_cache_find(cache, lba);
+    if (index == -1)
+    {
+        // Invalid entries sit at the tail, so they go before valid ones
+        index = cache->lru_tail;
+        struct disk_cache_entry* entry = &cache->entries[index];
+        if (entry->valid)
+        {
+            disk_cache_unhash(cache, index);
+            cache->evictions++;
+        }
+
+        entry->lba = lba;
+        entry->valid = true;
+        int bucket = disk_cache_bucket(lba);
+        entry->hash_next = cache->buckets[bucket];
+        cache->buckets[bucket] = index;
+
+        cache->misses++;
+        telemetry_count(&disk_cache_misses, 1);
+    }
+
+    memcpy(cache->data + index * cache->sector_size, data, cache->sector_size);
+    disk_cache_lru_remove(cache, index);
+    disk_cache_lru_push_front(cache, index);
+}
+
+// Forget one sector (for writes that bypass the cache)
+void disk_cache_invalidate(struct disk_cache* cache, unsigned int lba)
+{
+    int index = disk_cache_find(cache, lba);
+    if (index == -1)
+        return;
+
+    disk_cache_unhash(cache, index);
+    cache->entries[index].valid = false;
+    disk_cache_lru_remove(cache, index);
+    disk_cache_lru_push_back(cache, index);
+}
+
+void disk_cache_clear(struct disk_cache* cache)
+{
+    for (int i = 0; i < DISK_CACHE_BUCKETS; i++)
+    {
+        cache->buckets[i] = -1;
+    }
+
+    cache->lru_head = -1;
+    cache->lru_tail = -1;
+    for (int i = 0; i < cache->total; i++)
+    {
+        cache->entries[i].valid = false;
+        cache->entries[i].hash_next = -1;
+        disk_cache_lru_push_back(cache, i);
+    }
+}
+
+void disk_cache_get_stats(struct disk_cache* cache, struct disk_cache_stats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->total = cache->total;
+    for (int i = 0; i < cache->total; i++)
+    {
+        if (cache->entries[i].valid)
+            stats->used++;
+    }
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->evictions = cache->evictions;
+}
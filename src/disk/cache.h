@@ -0,0 +1,59 @@
+#ifndef DISK_CACHE_H
+#define DISK_CACHE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: Sector cache between disk_read_block() and the PIO port. Entries
+// are kept in LRU order and found through a small hash on the LBA.
+#define DISK_CACHE_BUCKETS 64
+
+struct disk_cache_entry
+{
+    unsigned int lba;
+    bool valid;
+
+    // LRU list, most recently used first (entry indexes, -1 ends)
+    int prev;
+    int next;
+
+    // Next entry in the same hash bucket
+    int hash_next;
+};
+
+struct disk_cache
+{
+    int total;
+    int sector_size;
+    struct disk_cache_entry* entries;
+
+    // total * sector_size bytes, entry i at data + i * sector_size
+    char* data;
+
+    int buckets[DISK_CACHE_BUCKETS];
+    int lru_head;
+    int lru_tail;
+
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+};
+
+struct disk_cache_stats
+{
+    int total;
+    int used;
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t evictions;
+};
+
+int disk_cache_init(struct disk_cache* cache, int total, int sector_size);
+void* disk_cache_lookup(struct disk_cache* cache, unsigned int lba);
+bool disk_cache_contains(struct disk_cache* cache, unsigned int lba);
+void disk_cache_insert(struct disk_cache* cache, unsigned int lba, const void* data);
+void disk_cache_invalidate(struct disk_cache* cache, unsigned int lba);
+void disk_cache_clear(struct disk_cache* cache);
+void disk_cache_get_stats(struct disk_cache* cache, struct disk_cache_stats* stats);
+
+#endif
@@ -1,12 +1,21 @@
 #include "disk.h"
+#include "dma.h"
+#include "queue.h"
 #include "io/io.h"
 #include "config.h"
 #include "status.h"
 #include "memory/memory.h"
+#include "telemetry/telemetry.h"
 
 
 struct disk disk;
 
+// ADDED: The sector count register is 8 bits; 0 means 256
+#define DISK_MAX_SECTORS_PER_COMMAND 256
+
+static TELEMETRY_COUNTER(disk_reads, "disk.reads");
+static TELEMETRY_COUNTER(disk_sectors, "disk.sectors");
+
 int disk_read_sector(int lba, int total, void* buf)
 {
     outb(0x1F6, (lba >> 24) | 0xE0);
@@ -45,6 +54,18 @@ void disk_search_and_init()
     disk.id = 0;
     //disk.filesystem = fs_resolve(&disk);
     disk.filesystem = 0;
+
+    // ADDED: Without a cache every read goes to the port, which still works
+    if (PEACHOS_DISK_CACHE_SECTORS > 0)
+    {
+        disk_cache_init(&disk.cache, PEACHOS_DISK_CACHE_SECTORS, disk.sector_size);
+    }
+
+    // ADDED: Bus-master DMA if the IDE controller has it
+    disk.dma = disk_dma_init();
+
+    // ADDED: Every read goes through the request queue from here on
+    disk_queue_init(&disk);
 }
 
 struct disk* disk_get(int index)
@@ -55,6 +76,102 @@ struct disk* disk_get(int index)
     return &disk;
 }
 
+// ADDED: One command's worth of sectors through the request queue (DMA
+// or PIO is its choice), waiting for it to finish
+static int disk_transfer(struct disk* idisk, unsigned int lba, int total, void* buf)
+{
+    telemetry_count(&disk_reads, 1);
+    telemetry_count(&disk_sectors, total);
+
+    if (!disk_queue_ready())
+    {
+        return disk_read_sector(lba, total, buf);
+    }
+
+    struct disk_request request;
+    memset(&request, 0, sizeof(request));
+    request.lba = lba;
+    request.total = total;
+    request.buf = buf;
+
+    int res = disk_queue_submit(&request);
+    if (res < 0)
+    {
+        return res;
+    }
+
+    return disk_request_wait(&request);
+}
+
+// ADDED: Read-through: cached sectors are copied out, each run of missing
+// sectors is one ATA command straight into buf and then cached
+static int disk_read_cached(struct disk* idisk, unsigned int lba, int total, void* buf)
+{
+    int res = 0;
+    struct disk_cache* cache = &idisk->cache;
+    char* out = (char*)buf;
+
+    while (total > 0)
+    {
+        void* cached = disk_cache_lookup(cache, lba);
+        if (cached)
+        {
+            memcpy(out, cached, idisk->sector_size);
+            lba++;
+            out += idisk->sector_size;
+            total--;
+            continue;
+        }
+
+        int run = 1;
+        while (run < total && !disk_cache_contains(cache, lba + run))
+        {
+            run++;
+        }
+
+        res = disk_transfer(idisk, lba, run, out);
+        if (res < 0)
+        {
+            goto out;
+        }
+
+        for (int i = 0; i < run; i++)
+        {
+            disk_cache_insert(cache, lba + i, out + i * idisk->sector_size);
+        }
+
+        lba += run;
+        out += run * idisk->sector_size;
+        total -= run;
+    }
+
+out:
+    return res;
+}
+
+// ADDED: As few commands as possible, each straight into buf
+static int disk_read_uncached(struct disk* idisk, unsigned int lba, int total, void* buf)
+{
+    int res = 0;
+    char* out = (char*)buf;
+
+    while (total > 0)
+    {
+        int count = (total < DISK_MAX_SECTORS_PER_COMMAND) ? total : DISK_MAX_SECTORS_PER_COMMAND;
+        res = disk_transfer(idisk, lba, count, out);
+        if (res < 0)
+        {
+            break;
+        }
+
+        lba += count;
+        out += count * PEACHOS_SECTOR_SIZE;
+        total -= count;
+    }
+
+    return res;
+}
+
 int disk_read_block(struct disk* idisk, unsigned int lba, int total, void* buf)
 {
     if (idisk != &disk)
@@ -62,5 +179,33 @@ int disk_read_block(struct disk* idisk, unsigned int lba, int total, void* buf)
         return -EIO;
     }
 
-    return disk_read_sector(lba, total, buf);
+    // ADDED: Bulk reads would only push the metadata out of the cache
+    if (idisk->cache.total == 0 || total > PEACHOS_DISK_CACHE_BYPASS)
+    {
+        return disk_read_uncached(idisk, lba, total, buf);
+    }
+
+    return disk_read_cached(idisk, lba, total, buf);
+}
+
+void disk_get_cache_stats(struct disk* idisk, struct disk_cache_stats* stats)
+{
+    if (idisk->cache.total == 0)
+    {
+        memset(stats, 0, sizeof(*stats));
+        return;
+    }
+
+    disk_cache_get_stats(&idisk->cache, stats);
+}
+
+// ADDED: Start a read and return at once. Doesn't go through the cache.
+int disk_read_block_async(struct disk* idisk, struct disk_request* request)
+{
+    if (idisk != &disk)
+    {
+        return -EIO;
+    }
+
+    return disk_queue_submit(request);
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define DISK_H
 
 #include "fs/file.h"
+#include "cache.h"
+#include "queue.h"
 
 typedef unsigned int PEACHOS_DISK_TYPE;
 
@@ -21,10 +23,18 @@ struct disk
 
     // The private data of our filesystem
     void* fs_private;
+
+    // ADDED: Recently read sectors (cache.total is 0 if there is none)
+    struct disk_cache cache;
+
+    // ADDED: Reads go through bus-master DMA (see dma.c)
+    bool dma;
 };
 
 void disk_search_and_init();
 struct disk* disk_get(int index);
 int disk_read_block(struct disk* idisk, unsigned int lba, int total, void* buf);
+void disk_get_cache_stats(struct disk* idisk, struct disk_cache_stats* stats);
+int disk_read_block_async(struct disk* idisk, struct disk_request* request);
 
 #endif
\ No newline at end of file
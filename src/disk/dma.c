@@ -0,0 +1,148 @@
+#include "dma.h"
+#include "pci/pci.h"
+#include "io/io.h"
+#include "status.h"
+#include "config.h"
+
+#define ATA_REG_COMMAND 0x1F7
+#define ATA_COMMAND_READ_DMA 0xC8
+#define ATA_STATUS_ERR 0x01
+#define ATA_STATUS_DF 0x20
+#define ATA_STATUS_BSY 0x80
+
+// ADDED: Polls of the status port before the drive is given up on
+#define DISK_DMA_TIMEOUT 10000000
+
+// ADDED: The table must not cross a 64 KB boundary; aligning it to its own
+// size takes care of that
+static struct disk_dma_prd disk_dma_prdt[DISK_DMA_MAX_PRDS] __attribute__((aligned(128)));
+static int disk_dma_prd_count = 0;
+static uint16_t disk_dma_base = 0;
+static bool disk_dma_ready = false;
+
+bool disk_dma_init()
+{
+    struct pci_device ide;
+    disk_dma_ready = false;
+
+    if (pci_find_class(PCI_CLASS_STORAGE, PCI_SUBCLASS_IDE, &ide) < 0)
+        return false;
+
+    // Programming interface bit 7: the controller can bus master
+    if (!(ide.prog_if & 0x80))
+        return false;
+
+    uint32_t bar4 = pci_config_read(&ide, PCI_REG_BAR4);
+    if (!(bar4 & 0x01))
+        return false;
+
+    disk_dma_base = bar4 & 0xFFFC;
+
+    // Only the low half: the status half is write-one-to-clear
+    uint32_t command = pci_config_read(&ide, PCI_REG_COMMAND) & 0xFFFF;
+    pci_config_write(&ide, PCI_REG_COMMAND, command | PCI_COMMAND_IO | PCI_COMMAND_BUS_MASTER);
+
+    outb(disk_dma_base + DISK_DMA_REG_COMMAND, 0);
+    disk_dma_ready = true;
+    return true;
+}
+
+bool disk_dma_available()
+{
+    return disk_dma_ready;
+}
+
+void disk_dma_prdt_reset()
+{
+    disk_dma_prd_count = 0;
+}
+
+// Split the buffer at 64 KB boundaries. Paging is an identity map, so the
+// buffer's address is its physical address.
+int disk_dma_prdt_add(void* buf, uint32_t bytes)
+{
+    uint32_t address = (uint32_t)buf;
+
+    // PRD addresses and sizes must be even
+    if ((address & 0x01) || (bytes & 0x01) || bytes == 0)
+        return -EINVARG;
+
+    int count = disk_dma_prd_count;
+    while (bytes > 0)
+    {
+        if (count == DISK_DMA_MAX_PRDS)
+        {
+            return -EINVARG;
+        }
+
+        uint32_t to_boundary = 0x10000 - (address & 0xFFFF);
+        uint32_t chunk = (bytes < to_boundary) ? bytes : to_boundary;
+
+        disk_dma_prdt[count].address = address;
+        disk_dma_prdt[count].bytes = chunk & 0xFFFF;
+        disk_dma_prdt[count].flags = 0;
+
+        address += chunk;
+        bytes -= chunk;
+        count++;
+    }
+
+    disk_dma_prd_count = count;
+    return 0;
+}
+
+void disk_dma_start(unsigned int lba, int total)
+{
+    uint16_t base = disk_dma_base;
+    disk_dma_prdt[disk_dma_prd_count - 1].flags = DISK_DMA_PRD_END;
+
+    outb(base + DISK_DMA_REG_COMMAND, 0);
+    outl(base + DISK_DMA_REG_PRDT, (uint32_t)disk_dma_prdt);
+    outb(base + DISK_DMA_REG_STATUS, DISK_DMA_STATUS_ERROR | DISK_DMA_STATUS_IRQ);
+    outb(base + DISK_DMA_REG_COMMAND, DISK_DMA_COMMAND_READ);
+
+    int spins = 0;
+    while ((insb(ATA_REG_COMMAND) & ATA_STATUS_BSY) && spins++ < DISK_DMA_TIMEOUT)
+    {
+    }
+
+    outb(0x1F6, (lba >> 24) | 0xE0);
+    outb(0x1F2, total);
+    outb(0x1F3, (unsigned char)(lba & 0xff));
+    outb(0x1F4, (unsigned char)(lba >> 8));
+    outb(0x1F5, (unsigned char)(lba >> 16));
+    outb(ATA_REG_COMMAND, ATA_COMMAND_READ_DMA);
+
+    outb(base + DISK_DMA_REG_COMMAND, DISK_DMA_COMMAND_READ | DISK_DMA_COMMAND_START);
+}
+
+// Done when the drive raises its interrupt or the engine stops
+bool disk_dma_finished()
+{
+    uint8_t status = insb(disk_dma_base + DISK_DMA_REG_STATUS);
+    return (status & DISK_DMA_STATUS_IRQ) || !(status & DISK_DMA_STATUS_ACTIVE);
+}
+
+int disk_dma_stop()
+{
+    uint16_t base = disk_dma_base;
+    uint8_t status = insb(base + DISK_DMA_REG_STATUS);
+    outb(base + DISK_DMA_REG_COMMAND, 0);
+
+    // Reading the ATA status also acknowledges the drive's interrupt
+    int spins = 0;
+    uint8_t ata_status = insb(ATA_REG_COMMAND);
+    while ((ata_status & ATA_STATUS_BSY) && spins++ < DISK_DMA_TIMEOUT)
+    {
+        ata_status = insb(ATA_REG_COMMAND);
+    }
+    outb(base + DISK_DMA_REG_STATUS, DISK_DMA_STATUS_ERROR | DISK_DMA_STATUS_IRQ);
+
+    if (spins >= DISK_DMA_TIMEOUT || (status & DISK_DMA_STATUS_ERROR) ||
+        (ata_status & (ATA_STATUS_ERR | ATA_STATUS_DF)))
+    {
+        return -EIO;
+    }
+
+    return 0;
+}
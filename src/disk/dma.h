@@ -0,0 +1,53 @@
+#ifndef DISK_DMA_H
+#define DISK_DMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: IDE bus-master DMA for the primary channel (PIIX on QEMU). The
+// controller is found on PCI; its BAR4 holds the bus-master registers.
+#define DISK_DMA_REG_COMMAND 0x00
+#define DISK_DMA_REG_STATUS 0x02
+#define DISK_DMA_REG_PRDT 0x04
+
+#define DISK_DMA_COMMAND_START 0x01
+#define DISK_DMA_COMMAND_READ 0x08  // Device to memory
+
+#define DISK_DMA_STATUS_ACTIVE 0x01
+#define DISK_DMA_STATUS_ERROR 0x02
+#define DISK_DMA_STATUS_IRQ 0x04
+
+// ADDED: One READ DMA command (the same limit as PIO)
+#define DISK_DMA_MAX_SECTORS 256
+
+// ADDED: Entries in the PRD table. Merged requests each bring their own
+// buffer, and every buffer may be split at 64 KB boundaries.
+#define DISK_DMA_MAX_PRDS 16
+
+// ADDED: Physical region descriptor: a buffer that must not cross a 64 KB
+// boundary. A byte count of 0 means 64 KB.
+struct disk_dma_prd
+{
+    uint32_t address;
+    uint16_t bytes;
+    uint16_t flags;
+} __attribute__((packed));
+
+#define DISK_DMA_PRD_END 0x8000
+
+bool disk_dma_init();
+bool disk_dma_available();
+
+// ADDED: One transfer is: disk_dma_prdt_reset(), disk_dma_prdt_add() for
+// each destination buffer in disk order, disk_dma_start(), then
+// disk_dma_stop() once disk_dma_finished() (polled or from IRQ14).
+void disk_dma_prdt_reset();
+// -EINVARG if buf can't be used for DMA or the table is full; the table
+// is left as it was
+int disk_dma_prdt_add(void* buf, uint32_t bytes);
+void disk_dma_start(unsigned int lba, int total);
+bool disk_dma_finished();
+// 0, or -EIO if the controller or the drive reported an error
+int disk_dma_stop();
+
+#endif
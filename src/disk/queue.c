@@ -0,0 +1,319 @@
+#include "queue.h"
+#include "disk.h"
+#include "dma.h"
+#include "io/io.h"
+#include "status.h"
+#include "config.h"
+#include "telemetry/telemetry.h"
+
+#define ATA_REG_DATA 0x1F0
+#define ATA_REG_COMMAND 0x1F7
+#define ATA_COMMAND_READ_SECTORS 0x20
+#define ATA_STATUS_ERR 0x01
+#define ATA_STATUS_DRQ 0x08
+#define ATA_STATUS_DF 0x20
+#define ATA_STATUS_BSY 0x80
+
+#define PIC_SLAVE_DATA 0xA1
+#define DISK_QUEUE_IRQ_LINE 6  // IRQ14 is line 6 on the slave PIC
+
+// ADDED: Sector count register limit
+#define DISK_QUEUE_MAX_SECTORS 256
+
+static struct disk* disk_queue_disk = 0;
+
+// Waiting requests, sorted by LBA
+static struct disk_request* disk_queue_pending = 0;
+
+// The command in flight: the requests merged into it, in disk order
+static struct disk_request* disk_queue_active = 0;
+static bool disk_queue_active_dma = false;
+
+// PIO: where the next sector goes
+static struct disk_request* disk_queue_pio_request = 0;
+static int disk_queue_pio_sector = 0;
+
+// C-SCAN head position: the LBA after the last command
+static unsigned int disk_queue_position = 0;
+
+static struct disk_queue_stats disk_queue_stats;
+
+static TELEMETRY_COUNTER(disk_queue_merges, "disk.queue_merges");
+static TELEMETRY_COUNTER(disk_dma_reads, "disk.dma_reads");
+
+static inline uint32_t disk_queue_irq_save()
+{
+    uint32_t flags;
+    __asm__ volatile("pushfl; popl %0; cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+static inline void disk_queue_irq_restore(uint32_t flags)
+{
+    __asm__ volatile("pushl %0; popfl" : : "r"(flags) : "memory", "cc");
+}
+
+void disk_queue_init(struct disk* disk)
+{
+    disk_queue_disk = disk;
+    disk_queue_pending = 0;
+    disk_queue_active = 0;
+
+    // ADDED: Let IRQ14 through the slave PIC (idt_init() set it up masked)
+    outb(PIC_SLAVE_DATA, insb(PIC_SLAVE_DATA) & ~(1 << DISK_QUEUE_IRQ_LINE));
+}
+
+bool disk_queue_ready()
+{
+    return disk_queue_disk != 0;
+}
+
+static void disk_queue_insert_sorted(struct disk_request* request)
+{
+    struct disk_request** link = &disk_queue_pending;
+    while (*link && (*link)->lba <= request->lba)
+    {
+        link = &(*link)->next;
+    }
+    request->next = *link;
+    *link = request;
+}
+
+static void disk_queue_pio_start(unsigned int lba, int total)
+{
+    outb(0x1F6, (lba >> 24) | 0xE0);
+    outb(0x1F2, total);
+    outb(0x1F3, (unsigned char)(lba & 0xff));
+    outb(0x1F4, (unsigned char)(lba >> 8));
+    outb(0x1F5, (unsigned char)(lba >> 16));
+    outb(ATA_REG_COMMAND, ATA_COMMAND_READ_SECTORS);
+}
+
+/*
+ * Take the next request in the sweep and whatever follows it on disk,
+ * up to one command's worth, and send the command. Interrupts are off.
+ */
+static void disk_queue_start_next()
+{
+    if (disk_queue_active || !disk_queue_pending)
+        return;
+
+    // First request at or after the head, else wrap to the lowest LBA
+    struct disk_request** link = &disk_queue_pending;
+    while (*link && (*link)->lba < disk_queue_position)
+    {
+        link = &(*link)->next;
+    }
+    if (!*link)
+    {
+        link = &disk_queue_pending;
+    }
+
+    struct disk_request* first = *link;
+    unsigned int lba = first->lba;
+    int total = first->total;
+
+    bool dma = disk_queue_disk->dma;
+    if (dma)
+    {
+        disk_dma_prdt_reset();
+        dma = disk_dma_prdt_add(first->buf, first->total * PEACHOS_SECTOR_SIZE) == 0;
+    }
+
+    // Merge the requests that carry on where this one ends
+    struct disk_request* last = first;
+    while (last->next && last->next->lba == lba + total &&
+           total + last->next->total <= DISK_QUEUE_MAX_SECTORS)
+    {
+        struct disk_request* next = last->next;
+        if (dma && disk_dma_prdt_add(next->buf, next->total * PEACHOS_SECTOR_SIZE) < 0)
+            break;
+
+        total += next->total;
+        last = next;
+        disk_queue_stats.merged++;
+        telemetry_count(&disk_queue_merges, 1);
+    }
+
+    // Unlink first..last, which sit next to each other in the sorted list
+    *link = last->next;
+    last->next = 0;
+
+    disk_queue_active = first;
+    disk_queue_active_dma = dma;
+    disk_queue_position = lba + total;
+    disk_queue_stats.commands++;
+
+    if (dma)
+    {
+        disk_queue_stats.dma_commands++;
+        telemetry_count(&disk_dma_reads, 1);
+        disk_dma_start(lba, total);
+    }
+    else
+    {
+        disk_queue_pio_request = first;
+        disk_queue_pio_sector = 0;
+        disk_queue_pio_start(lba, total);
+    }
+}
+
+static void disk_queue_complete_active(int status)
+{
+    struct disk_request* request = disk_queue_active;
+    disk_queue_active = 0;
+
+    while (request)
+    {
+        // The request may be reused as soon as status is set
+        struct disk_request* next = request->next;
+        DISK_REQUEST_CALLBACK callback = request->callback;
+        request->next = 0;
+        request->status = status;
+        if (callback)
+        {
+            callback(request);
+        }
+        request = next;
+    }
+}
+
+// ADDED: DMA error: give the requests back to the queue and use PIO
+static void disk_queue_retry_active_with_pio()
+{
+    struct disk_request* request = disk_queue_active;
+    disk_queue_active = 0;
+    disk_queue_disk->dma = false;
+    telemetry_log("disk: DMA read failed, using PIO");
+
+    while (request)
+    {
+        struct disk_request* next = request->next;
+        disk_queue_insert_sorted(request);
+        request = next;
+    }
+}
+
+// Read the sectors the drive has ready. True once the command is done.
+static bool disk_queue_service_pio(int* status)
+{
+    while (1)
+    {
+        uint8_t ata_status = insb(ATA_REG_COMMAND);
+        if (ata_status & ATA_STATUS_BSY)
+            return false;
+
+        if (ata_status & (ATA_STATUS_ERR | ATA_STATUS_DF))
+        {
+            *status = -EIO;
+            return true;
+        }
+
+        if (!(ata_status & ATA_STATUS_DRQ))
+            return false;
+
+        struct disk_request* request = disk_queue_pio_request;
+        unsigned short* ptr = (unsigned short*)((char*)request->buf + disk_queue_pio_sector * PEACHOS_SECTOR_SIZE);
+        for (int i = 0; i < 256; i++)
+        {
+            *ptr = insw(ATA_REG_DATA);
+            ptr++;
+        }
+
+        disk_queue_pio_sector++;
+        if (disk_queue_pio_sector == request->total)
+        {
+            disk_queue_pio_request = request->next;
+            disk_queue_pio_sector = 0;
+            if (!disk_queue_pio_request)
+            {
+                *status = 0;
+                return true;
+            }
+        }
+    }
+}
+
+// Interrupts are off
+static void disk_queue_service()
+{
+    if (!disk_queue_active)
+    {
+        // Nothing of ours in flight: just acknowledge the drive
+        insb(ATA_REG_COMMAND);
+        return;
+    }
+
+    int status = 0;
+    if (disk_queue_active_dma)
+    {
+        if (!disk_dma_finished())
+            return;
+
+        status = disk_dma_stop();
+        if (status < 0)
+        {
+            disk_queue_retry_active_with_pio();
+            disk_queue_start_next();
+            return;
+        }
+    }
+    else if (!disk_queue_service_pio(&status))
+    {
+        return;
+    }
+
+    disk_queue_complete_active(status);
+    disk_queue_start_next();
+}
+
+// ADDED: From irq14_handler in idt.asm
+void disk_queue_irq()
+{
+    disk_queue_service();
+}
+
+void disk_queue_poll()
+{
+    uint32_t flags = disk_queue_irq_save();
+    disk_queue_service();
+    disk_queue_irq_restore(flags);
+}
+
+int disk_queue_submit(struct disk_request* request)
+{
+    if (!disk_queue_disk || request->total <= 0 || request->total > DISK_QUEUE_MAX_SECTORS)
+        return -EINVARG;
+
+    request->status = DISK_REQUEST_PENDING;
+    request->next = 0;
+
+    uint32_t flags = disk_queue_irq_save();
+    disk_queue_stats.requests++;
+    disk_queue_insert_sorted(request);
+    disk_queue_start_next();
+    disk_queue_irq_restore(flags);
+    return 0;
+}
+
+bool disk_request_done(struct disk_request* request)
+{
+    return request->status != DISK_REQUEST_PENDING;
+}
+
+// Polls too, so this also works with interrupts off
+int disk_request_wait(struct disk_request* request)
+{
+    while (request->status == DISK_REQUEST_PENDING)
+    {
+        disk_queue_poll();
+    }
+    return request->status;
+}
+
+void disk_queue_get_stats(struct disk_queue_stats* stats)
+{
+    uint32_t flags = disk_queue_irq_save();
+    *stats = disk_queue_stats;
+    disk_queue_irq_restore(flags);
+}
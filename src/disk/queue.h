@@ -0,0 +1,62 @@
+#ifndef DISK_QUEUE_H
+#define DISK_QUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: Asynchronous reads on the primary ATA channel. Requests are kept
+// sorted by LBA and served in one sweep across the disk (C-SCAN); requests
+// that continue each other on disk go out as one command. IRQ14 moves the
+// queue along, so the submitter can keep working.
+#define DISK_QUEUE_IRQ_INTERRUPT 0x2E
+
+#define DISK_REQUEST_PENDING 1
+
+struct disk;
+struct disk_request;
+
+// ADDED: Called from the IRQ14 handler (interrupts off) once the request
+// is done; request->status is 0 or a negative error
+typedef void (*DISK_REQUEST_CALLBACK)(struct disk_request* request);
+
+struct disk_request
+{
+    unsigned int lba;
+    int total;
+    void* buf;
+
+    // Optional, and private is the caller's
+    DISK_REQUEST_CALLBACK callback;
+    void* private;
+
+    // DISK_REQUEST_PENDING until done, then 0 or a negative error
+    volatile int status;
+
+    struct disk_request* next;
+};
+
+void disk_queue_init(struct disk* disk);
+bool disk_queue_ready();
+
+// ADDED: The request must stay in place until it is done. Don't wait on a
+// request that has a callback which frees or reuses it.
+int disk_queue_submit(struct disk_request* request);
+bool disk_request_done(struct disk_request* request);
+int disk_request_wait(struct disk_request* request);
+
+// ADDED: Move the queue along without the interrupt (interrupts off, or
+// IRQ14 lost). disk_request_wait() does this as it waits.
+void disk_queue_poll();
+
+// ADDED: Requests served and how many commands they took
+struct disk_queue_stats
+{
+    uint32_t requests;
+    uint32_t commands;
+    uint32_t merged;
+    uint32_t dma_commands;
+};
+
+void disk_queue_get_stats(struct disk_queue_stats* stats);
+
+#endif
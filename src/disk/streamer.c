@@ -1,6 +1,8 @@
 #include "streamer.h"
 #include "memory/heap/kheap.h"
+#include "memory/memory.h"
 #include "config.h"
+#include "status.h"
 struct disk_stream* diskstreamer_new(int disk_id)
 {
     struct disk* disk = disk_get(disk_id);
@@ -10,6 +12,11 @@ struct disk_stream* diskstreamer_new(int disk_id)
     }
 
     struct disk_stream* streamer = kzalloc(sizeof(struct disk_stream));
+    if (!streamer)
+    {
+        return 0;
+    }
+
     streamer->pos = 0;
     streamer->disk = disk;
     return streamer;
@@ -21,24 +28,89 @@ int diskstreamer_seek(struct disk_stream* stream, int pos)
     return 0;
 }
 
+// ADDED: 0 or 1 turns read-ahead off
+int diskstreamer_set_readahead(struct disk_stream* stream, int sectors)
+{
+    int res = 0;
+
+    kfree(stream->readahead_buf);
+    stream->readahead_buf = 0;
+    stream->readahead = 0;
+    stream->readahead_count = 0;
+
+    if (sectors <= 1)
+    {
+        goto out;
+    }
+
+    stream->readahead_buf = kmalloc(sectors * PEACHOS_SECTOR_SIZE);
+    if (!stream->readahead_buf)
+    {
+        res = -ENOMEM;
+        goto out;
+    }
+    stream->readahead = sectors;
+
+out:
+    return res;
+}
+
 int diskstreamer_read(struct disk_stream* stream, void* out, int total)
 {
     int res = 0;
 
     while (total > 0)
     {
-        int sector = stream->pos / PEACHOS_SECTOR_SIZE;
+        unsigned int sector = stream->pos / PEACHOS_SECTOR_SIZE;
         int offset = stream->pos % PEACHOS_SECTOR_SIZE;
+        int to_copy = 0;
+
+        if (stream->readahead_count > 0 && sector >= stream->readahead_lba &&
+            sector < stream->readahead_lba + stream->readahead_count)
+        {
+            // ADDED: Already read ahead
+            int start = (sector - stream->readahead_lba) * PEACHOS_SECTOR_SIZE + offset;
+            int available = stream->readahead_count * PEACHOS_SECTOR_SIZE - start;
+            to_copy = (total < available) ? total : available;
+            memcpy(out, stream->readahead_buf + start, to_copy);
+        }
+        else if (offset == 0 && total / PEACHOS_SECTOR_SIZE >= (stream->readahead ? stream->readahead : 1))
+        {
+            // ADDED: Whole sectors go straight into the caller's buffer,
+            // as few ATA commands as disk_read_block() can make of them
+            int count = total / PEACHOS_SECTOR_SIZE;
+            res = disk_read_block(stream->disk, sector, count, out);
+            if (res < 0)
+                return res;
 
-        char buf[PEACHOS_SECTOR_SIZE];
-        res = disk_read_block(stream->disk, sector, 1, buf);
-        if (res < 0)
-            return res;
+            to_copy = count * PEACHOS_SECTOR_SIZE;
+        }
+        else if (stream->readahead)
+        {
+            // ADDED: Part of a sector, or a short read: fill the window
+            res = disk_read_block(stream->disk, sector, stream->readahead, stream->readahead_buf);
+            if (res < 0)
+            {
+                stream->readahead_count = 0;
+                return res;
+            }
 
-        int remaining_in_sector = PEACHOS_SECTOR_SIZE - offset;
-        int to_copy = (total < remaining_in_sector) ? total : remaining_in_sector;
+            stream->readahead_lba = sector;
+            stream->readahead_count = stream->readahead;
+            continue;
+        }
+        else
+        {
+            char buf[PEACHOS_SECTOR_SIZE];
+            res = disk_read_block(stream->disk, sector, 1, buf);
+            if (res < 0)
+                return res;
 
-        memcpy(out, buf + offset, to_copy);
+            int remaining_in_sector = PEACHOS_SECTOR_SIZE - offset;
+            to_copy = (total < remaining_in_sector) ? total : remaining_in_sector;
+
+            memcpy(out, buf + offset, to_copy);
+        }
 
         stream->pos += to_copy;
         out = (char*)out + to_copy;
@@ -50,5 +122,6 @@ int diskstreamer_read(struct disk_stream* stream, void* out, int total)
 
 void diskstreamer_close(struct disk_stream* stream)
 {
+    kfree(stream->readahead_buf);
     kfree(stream);
-}
\ No newline at end of file
+}
@@ -7,11 +7,19 @@ struct disk_stream
 {
     int pos;
     struct disk* disk;
+
+    // ADDED: Read-ahead window. Reads that don't cover whole sectors pull
+    // in readahead sectors at once and later reads are served from here.
+    int readahead;
+    char* readahead_buf;
+    unsigned int readahead_lba;
+    int readahead_count;
 };
 
 struct disk_stream* diskstreamer_new(int disk_id);
 int diskstreamer_seek(struct disk_stream* stream, int pos);
 int diskstreamer_read(struct disk_stream* stream, void* out, int total);
+int diskstreamer_set_readahead(struct disk_stream* stream, int sectors);
 void diskstreamer_close(struct disk_stream* stream);
 
 #endif
\ No newline at end of file
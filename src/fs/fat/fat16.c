@@ -5,7 +5,10 @@
 #include "memory/heap/kheap.h"
 #include "memory/memory.h"
 #include "status.h"
+#include "config.h"
 #include "kernel.h"
+#include "telemetry/telemetry.h"
+#include "include/ctype.h"
 #include <stdint.h>
 
 #define PEACHOS_FAT16_SIGNATURE 0x29
@@ -86,6 +89,11 @@ struct fat_directory
     int total;
     int sector_pos;
     int ending_sector_pos;
+
+    // ADDED: First cluster (0 for the root directory). Loaded
+    // subdirectories stay on fat_private's list and are shared.
+    int cluster;
+    struct fat_directory *next;
 };
 
 struct fat_item
@@ -98,10 +106,82 @@ struct fat_item
     FAT_ITEM_TYPE type;
 };
 
+// ADDED: Clusters index..index+count-1 of a file are clusters
+// cluster..cluster+count-1 on disk
+struct fat_cluster_run
+{
+    uint32_t index;
+    uint32_t cluster;
+    uint32_t count;
+};
+
+// ADDED: Where the last read stopped in a cluster chain, so the next one
+// carries on from there instead of walking the chain from the start.
+// With a run list (built at open) any cluster is found without the FAT.
+struct fat_cluster_cursor
+{
+    uint32_t index;
+    int cluster;  // 0 until the first lookup
+
+    struct fat_cluster_run *runs;
+    int total_runs;
+    int run;      // Run of the last lookup
+};
+
 struct fat_file_descriptor
 {
     struct fat_item *item;
     uint32_t pos;
+
+    // ADDED: Position in the file's cluster chain
+    struct fat_cluster_cursor cursor;
+};
+
+// ADDED: Per-sector state of the in-memory FAT
+#define FAT16_TABLE_SECTOR_LOADED 0x01
+#define FAT16_TABLE_SECTOR_DIRTY 0x02
+
+// ADDED: The first FAT copy in memory. Sectors are read the first time an
+// entry in them is needed; set entries mark their sector dirty for
+// fat16_flush_fat_table().
+struct fat_table
+{
+    uint16_t *entries;
+    uint32_t total_entries;
+    uint32_t first_sector;
+    uint32_t total_sectors;
+    uint8_t *sector_state;
+};
+
+// ADDED: Longest 8.3 name, "NAME.EXT" plus the terminator
+#define FAT16_DENTRY_NAME_MAX 13
+
+// ADDED: The result of looking a name up in a directory, found or not
+struct fat_dentry
+{
+    int parent_cluster;
+    uint32_t hash;
+    char name[FAT16_DENTRY_NAME_MAX];
+    bool valid;
+    bool negative;  // The name isn't in the directory
+    struct fat_directory_item item;
+
+    // LRU list and hash chain, like the disk cache (indexes, -1 ends)
+    int prev;
+    int next;
+    int hash_next;
+};
+
+#define FAT16_DENTRY_BUCKETS 32
+
+// ADDED: Dentries found by (parent cluster, name hash). The volume is
+// read only, so entries never go stale.
+struct fat_dentry_cache
+{
+    struct fat_dentry entries[PEACHOS_FAT16_DENTRY_CACHE];
+    int buckets[FAT16_DENTRY_BUCKETS];
+    int lru_head;
+    int lru_tail;
 };
 
 struct fat_private
@@ -109,10 +189,15 @@ struct fat_private
     struct fat_h header;
     struct fat_directory root_directory;
 
+    // ADDED: Cluster chains are looked up here instead of on disk
+    struct fat_table fat_table;
+
+    // ADDED: Subdirectories loaded so far, and recent name lookups
+    struct fat_directory *directories;
+    struct fat_dentry_cache dentry_cache;
+
     // Used to stream data clusters
     struct disk_stream *cluster_read_stream;
-    // Used to stream the file allocation table
-    struct disk_stream *fat_read_stream;
 
     // Used in situations where we stream the directory
     struct disk_stream *directory_stream;
@@ -124,6 +209,9 @@ int fat16_read(struct disk *disk, void *descriptor, uint32_t size, uint32_t nmem
 int fat16_seek(void *private, uint32_t offset, FILE_SEEK_MODE seek_mode);
 int fat16_stat(struct disk* disk, void* private, struct file_stat* stat);
 int fat16_close(void* private);
+int fat16_set_fat_entry(struct disk *disk, int cluster, uint16_t value);
+int fat16_flush_fat_table(struct disk *disk);
+static int fat16_init_fat_table(struct disk *disk, struct fat_private *private);
 
 struct filesystem fat16_fs =
     {
@@ -135,21 +223,36 @@ struct filesystem fat16_fs =
         .close = fat16_close
     };
 
+static TELEMETRY_COUNTER(fat16_opens, "fat16.opens");
+static TELEMETRY_COUNTER(fat16_reads, "fat16.reads");
+static TELEMETRY_COUNTER(fat16_read_bytes, "fat16.read_bytes");
+static TELEMETRY_COUNTER(fat16_fat_lookups, "fat16.fat_lookups");
+static TELEMETRY_COUNTER(fat16_fat_sector_loads, "fat16.fat_sector_loads");
+static TELEMETRY_COUNTER(fat16_dentry_hits, "fat16.dentry_hits");
+static TELEMETRY_COUNTER(fat16_dentry_misses, "fat16.dentry_misses");
+static TELEMETRY_COUNTER(fat16_directory_loads, "fat16.directory_loads");
+
 struct filesystem *fat16_init()
 {
     strcpy(fat16_fs.name, "FAT16");
     return &fat16_fs;
 }
 
+static void fat16_dentry_cache_init(struct fat_dentry_cache *cache);
+
 static void fat16_init_private(struct disk *disk, struct fat_private *private)
 {
     memset(private, 0, sizeof(struct fat_private));
 private
     ->cluster_read_stream = diskstreamer_new(disk->id);
-private
-    ->fat_read_stream = diskstreamer_new(disk->id);
 private
     ->directory_stream = diskstreamer_new(disk->id);
+
+    // ADDED: Directory items and file data are read front to back
+    diskstreamer_set_readahead(private->directory_stream, PEACHOS_DISK_READAHEAD_SECTORS);
+    diskstreamer_set_readahead(private->cluster_read_stream, PEACHOS_DISK_READAHEAD_SECTORS);
+
+    fat16_dentry_cache_init(&private->dentry_cache);
 }
 
 int fat16_sector_to_absolute(struct disk *disk, int sector)
@@ -274,6 +377,12 @@ int fat16_resolve(struct disk *disk)
         goto out;
     }
 
+    res = fat16_init_fat_table(disk, fat_private);
+    if (res < 0)
+    {
+        goto out;
+    }
+
     if (fat16_get_root_directory(disk, fat_private, &fat_private->root_directory) != PEACHOS_ALL_OK)
     {
         res = -EIO;
@@ -288,6 +397,8 @@ out:
 
     if (res < 0)
     {
+        kfree(fat_private->fat_table.entries);
+        kfree(fat_private->fat_table.sector_state);
         kfree(fat_private);
         disk->fs_private = 0;
     }
@@ -354,70 +465,197 @@ static uint32_t fat16_get_first_fat_sector(struct fat_private *private)
     return private->header.primary_header.reserved_sectors;
 }
 
+// ADDED: Read one sector of the first FAT copy into the table
+static int fat16_load_fat_sector(struct disk *disk, struct fat_table *table, uint32_t sector)
+{
+    int res = 0;
+    if (table->sector_state[sector] & FAT16_TABLE_SECTOR_LOADED)
+    {
+        goto out;
+    }
+
+    void *dest = (char *)table->entries + sector * disk->sector_size;
+    res = disk_read_block(disk, table->first_sector + sector, 1, dest);
+    if (res < 0)
+    {
+        goto out;
+    }
+
+    table->sector_state[sector] |= FAT16_TABLE_SECTOR_LOADED;
+    telemetry_count(&fat16_fat_sector_loads, 1);
+
+out:
+    return res;
+}
+
+// ADDED: Room for the whole FAT; no sector is loaded yet
+static int fat16_init_fat_table(struct disk *disk, struct fat_private *private)
+{
+    int res = 0;
+    struct fat_table *table = &private->fat_table;
+    struct fat_header *header = &private->header.primary_header;
+
+    table->first_sector = fat16_get_first_fat_sector(private);
+    table->total_sectors = header->sectors_per_fat;
+    table->total_entries = (table->total_sectors * disk->sector_size) / PEACHOS_FAT16_FAT_ENTRY_SIZE;
+    table->entries = kmalloc(table->total_sectors * disk->sector_size);
+    table->sector_state = kzalloc(table->total_sectors);
+    if (!table->entries || !table->sector_state)
+    {
+        res = -ENOMEM;
+        goto out;
+    }
+
+out:
+    return res;
+}
+
+// ADDED: The FAT entry for cluster, from memory once its sector is loaded
 static int fat16_get_fat_entry(struct disk *disk, int cluster)
 {
-    int res = -1;
+    int res = -EIO;
     struct fat_private *private = disk->fs_private;
-    struct disk_stream *stream = private->fat_read_stream;
-    if (!stream)
+    struct fat_table *table = &private->fat_table;
+    if (cluster < 0 || (uint32_t)cluster >= table->total_entries)
     {
         goto out;
     }
 
-    uint32_t fat_table_position = fat16_get_first_fat_sector(private) * disk->sector_size;
-    res = diskstreamer_seek(stream, fat_table_position * (cluster * PEACHOS_FAT16_FAT_ENTRY_SIZE));
+    telemetry_count(&fat16_fat_lookups, 1);
+
+    uint32_t sector = (cluster * PEACHOS_FAT16_FAT_ENTRY_SIZE) / disk->sector_size;
+    res = fat16_load_fat_sector(disk, table, sector);
     if (res < 0)
     {
         goto out;
     }
 
-    uint16_t result = 0;
-    res = diskstreamer_read(stream, &result, sizeof(result));
+    res = table->entries[cluster];
+out:
+    return res;
+}
+
+// ADDED: Write support goes through here: the entry changes in memory and
+// its sector is written back by fat16_flush_fat_table()
+int fat16_set_fat_entry(struct disk *disk, int cluster, uint16_t value)
+{
+    int res = -EIO;
+    struct fat_private *private = disk->fs_private;
+    struct fat_table *table = &private->fat_table;
+    if (cluster < 0 || (uint32_t)cluster >= table->total_entries)
+    {
+        goto out;
+    }
+
+    uint32_t sector = (cluster * PEACHOS_FAT16_FAT_ENTRY_SIZE) / disk->sector_size;
+    res = fat16_load_fat_sector(disk, table, sector);
     if (res < 0)
     {
         goto out;
     }
 
-    res = result;
+    table->entries[cluster] = value;
+    table->sector_state[sector] |= FAT16_TABLE_SECTOR_DIRTY;
 out:
     return res;
 }
+
+// ADDED: Each dirty sector has to go to every FAT copy. The disk layer
+// can't write yet, so nothing is written and dirty sectors stay dirty.
+int fat16_flush_fat_table(struct disk *disk)
+{
+    struct fat_private *private = disk->fs_private;
+    struct fat_table *table = &private->fat_table;
+    for (uint32_t sector = 0; sector < table->total_sectors; sector++)
+    {
+        if (table->sector_state[sector] & FAT16_TABLE_SECTOR_DIRTY)
+        {
+            return -EUNIMP;
+        }
+    }
+
+    return 0;
+}
+// ADDED: Entries that point at another cluster of the same chain.
+// 0 is free, 0xFFF0-0xFFF6 reserved, 0xFFF7 bad, 0xFFF8 and up end of chain.
+static bool fat16_is_next_cluster(int entry)
+{
+    return entry >= 2 && entry < 0xFFF0;
+}
+
+// ADDED: The run that holds cluster index. Sequential reads stay in the
+// run of the last lookup or move to the next one; anything else is a
+// binary search.
+static int fat16_find_run(struct fat_cluster_cursor *cursor, uint32_t index)
+{
+    for (int run = cursor->run; run < cursor->total_runs && run <= cursor->run + 1; run++)
+    {
+        struct fat_cluster_run *r = &cursor->runs[run];
+        if (index >= r->index && index < r->index + r->count)
+            return run;
+    }
+
+    int low = 0;
+    int high = cursor->total_runs - 1;
+    while (low <= high)
+    {
+        int middle = (low + high) / 2;
+        struct fat_cluster_run *r = &cursor->runs[middle];
+        if (index < r->index)
+            high = middle - 1;
+        else if (index >= r->index + r->count)
+            low = middle + 1;
+        else
+            return middle;
+    }
+
+    return -EIO;
+}
+
 /**
  * Gets the correct cluster to use based on the starting cluster and the offset
+ *
+ * ADDED: With a cursor the walk starts where the last lookup stopped (or
+ * uses the cursor's run list), and the cursor is moved to the result.
  */
-static int fat16_get_cluster_for_offset(struct disk *disk, int starting_cluster, int offset)
+static int fat16_get_cluster_for_offset(struct disk *disk, int starting_cluster, int offset, struct fat_cluster_cursor *cursor)
 {
     int res = 0;
     struct fat_private *private = disk->fs_private;
     int size_of_cluster_bytes = private->header.primary_header.sectors_per_cluster * disk->sector_size;
     int cluster_to_use = starting_cluster;
-    int clusters_ahead = offset / size_of_cluster_bytes;
-    for (int i = 0; i < clusters_ahead; i++)
+    uint32_t clusters_ahead = offset / size_of_cluster_bytes;
+    uint32_t i = 0;
+
+    if (cursor && cursor->runs)
     {
-        int entry = fat16_get_fat_entry(disk, cluster_to_use);
-        if (entry == 0xFF8 || entry == 0xFFF)
+        int run = fat16_find_run(cursor, clusters_ahead);
+        if (run < 0)
         {
-            // We are at the last entry in the file
-            res = -EIO;
+            res = run;
             goto out;
         }
 
-        // Sector is marked as bad?
-        if (entry == PEACHOS_FAT16_BAD_SECTOR)
-        {
-            res = -EIO;
-            goto out;
-        }
+        struct fat_cluster_run *r = &cursor->runs[run];
+        cursor->run = run;
+        cursor->index = clusters_ahead;
+        cursor->cluster = r->cluster + (clusters_ahead - r->index);
+        res = cursor->cluster;
+        goto out;
+    }
 
-        // Reserved sector?
-        if (entry == 0xFF0 || entry == 0xFF6)
-        {
-            res = -EIO;
-            goto out;
-        }
+    if (cursor && cursor->cluster && cursor->index <= clusters_ahead)
+    {
+        cluster_to_use = cursor->cluster;
+        i = cursor->index;
+    }
 
-        if (entry == 0x00)
+    for (; i < clusters_ahead; i++)
+    {
+        int entry = fat16_get_fat_entry(disk, cluster_to_use);
+        if (!fat16_is_next_cluster(entry))
         {
+            // End of the chain, or a bad, reserved or free cluster
             res = -EIO;
             goto out;
         }
@@ -425,55 +663,176 @@ static int fat16_get_cluster_for_offset(struct disk *disk, int starting_cluster,
         cluster_to_use = entry;
     }
 
+    if (cursor)
+    {
+        cursor->index = clusters_ahead;
+        cursor->cluster = cluster_to_use;
+    }
+
     res = cluster_to_use;
 out:
     return res;
 }
-static int fat16_read_internal_from_stream(struct disk *disk, struct disk_stream *stream, int cluster, int offset, int total, void *out)
+
+// ADDED: Walk the chain once and store it as runs of consecutive clusters
+static int fat16_build_cluster_runs(struct disk *disk, int first_cluster, uint32_t total_clusters, struct fat_cluster_cursor *cursor)
 {
     int res = 0;
-    struct fat_private *private = disk->fs_private;
-    int size_of_cluster_bytes = private->header.primary_header.sectors_per_cluster * disk->sector_size;
-    int cluster_to_use = fat16_get_cluster_for_offset(disk, cluster, offset);
-    if (cluster_to_use < 0)
+    int capacity = 8;
+    struct fat_cluster_run *runs = kmalloc(capacity * sizeof(struct fat_cluster_run));
+    int total_runs = 0;
+    if (!runs)
     {
-        res = cluster_to_use;
+        res = -ENOMEM;
         goto out;
     }
 
-    int offset_from_cluster = offset % size_of_cluster_bytes;
+    int cluster = first_cluster;
+    for (uint32_t index = 0; index < total_clusters; index++)
+    {
+        if (index > 0)
+        {
+            cluster = fat16_get_fat_entry(disk, cluster);
+            if (!fat16_is_next_cluster(cluster))
+            {
+                res = -EIO;
+                goto out;
+            }
+        }
 
-    int starting_sector = fat16_cluster_to_sector(private, cluster_to_use);
-    int starting_pos = (starting_sector * disk->sector_size) + offset_from_cluster;
-    int total_to_read = total > size_of_cluster_bytes ? size_of_cluster_bytes : total;
-    res = diskstreamer_seek(stream, starting_pos);
-    if (res != PEACHOS_ALL_OK)
+        struct fat_cluster_run *last = total_runs ? &runs[total_runs - 1] : 0;
+        if (last && last->cluster + last->count == (uint32_t)cluster)
+        {
+            last->count++;
+            continue;
+        }
+
+        if (total_runs == capacity)
+        {
+            struct fat_cluster_run *bigger = kmalloc(capacity * 2 * sizeof(struct fat_cluster_run));
+            if (!bigger)
+            {
+                res = -ENOMEM;
+                goto out;
+            }
+            memcpy(bigger, runs, total_runs * sizeof(struct fat_cluster_run));
+            kfree(runs);
+            runs = bigger;
+            capacity *= 2;
+        }
+
+        runs[total_runs].index = index;
+        runs[total_runs].cluster = cluster;
+        runs[total_runs].count = 1;
+        total_runs++;
+    }
+
+    cursor->runs = runs;
+    cursor->total_runs = total_runs;
+    cursor->run = 0;
+
+out:
+    if (res < 0)
     {
-        goto out;
+        kfree(runs);
     }
+    return res;
+}
 
-    res = diskstreamer_read(stream, out, total_to_read);
-    if (res != PEACHOS_ALL_OK)
+// ADDED: How many clusters from cluster_to_use (the cursor's cluster) on
+// are consecutive on disk, up to max_clusters. The cursor ends on the
+// last one, which is where the next read of the file starts looking.
+static int fat16_contiguous_clusters(struct disk *disk, int cluster_to_use, int max_clusters, struct fat_cluster_cursor *cursor)
+{
+    if (cursor && cursor->runs)
     {
-        goto out;
+        struct fat_cluster_run *r = &cursor->runs[cursor->run];
+        int count = r->count - (cursor->index - r->index);
+        if (count > max_clusters)
+            count = max_clusters;
+
+        cursor->index += count - 1;
+        cursor->cluster += count - 1;
+        return count;
+    }
+
+    int count = 1;
+    while (count < max_clusters && fat16_get_fat_entry(disk, cluster_to_use) == cluster_to_use + 1)
+    {
+        cluster_to_use++;
+        count++;
+    }
+
+    if (cursor)
+    {
+        cursor->index += count - 1;
+        cursor->cluster = cluster_to_use;
+    }
+    return count;
+}
+
+/*
+ * ADDED: One stream read per run of consecutive clusters rather than per
+ * cluster. The stream hands whole sectors to disk_read_block() straight
+ * into out, so a file laid out in one piece is one transfer.
+ */
+static int fat16_read_internal_from_stream(struct disk *disk, struct disk_stream *stream, int cluster, int offset, int total, void *out, struct fat_cluster_cursor *cursor)
+{
+    int res = 0;
+    struct fat_private *private = disk->fs_private;
+    int size_of_cluster_bytes = private->header.primary_header.sectors_per_cluster * disk->sector_size;
+
+    // Runs are followed through the cursor, so always have one
+    struct fat_cluster_cursor local_cursor;
+    if (!cursor)
+    {
+        memset(&local_cursor, 0, sizeof(local_cursor));
+        cursor = &local_cursor;
     }
 
-    total -= total_to_read;
-    if (total > 0)
+    while (total > 0)
     {
-        // We still have more to read
-        res = fat16_read_internal_from_stream(disk, stream, cluster, offset + total_to_read, total, out + total_to_read);
+        int cluster_to_use = fat16_get_cluster_for_offset(disk, cluster, offset, cursor);
+        if (cluster_to_use < 0)
+        {
+            res = cluster_to_use;
+            goto out;
+        }
+
+        int offset_from_cluster = offset % size_of_cluster_bytes;
+        int clusters_wanted = (offset_from_cluster + total + size_of_cluster_bytes - 1) / size_of_cluster_bytes;
+        int clusters = fat16_contiguous_clusters(disk, cluster_to_use, clusters_wanted, cursor);
+
+        int starting_sector = fat16_cluster_to_sector(private, cluster_to_use);
+        int starting_pos = (starting_sector * disk->sector_size) + offset_from_cluster;
+        int remaining_in_run = clusters * size_of_cluster_bytes - offset_from_cluster;
+        int total_to_read = total > remaining_in_run ? remaining_in_run : total;
+        res = diskstreamer_seek(stream, starting_pos);
+        if (res != PEACHOS_ALL_OK)
+        {
+            goto out;
+        }
+
+        res = diskstreamer_read(stream, out, total_to_read);
+        if (res != PEACHOS_ALL_OK)
+        {
+            goto out;
+        }
+
+        out += total_to_read;
+        offset += total_to_read;
+        total -= total_to_read;
     }
 
 out:
     return res;
 }
 
-static int fat16_read_internal(struct disk *disk, int starting_cluster, int offset, int total, void *out)
+static int fat16_read_internal(struct disk *disk, int starting_cluster, int offset, int total, void *out, struct fat_cluster_cursor *cursor)
 {
     struct fat_private *fs_private = disk->fs_private;
     struct disk_stream *stream = fs_private->cluster_read_stream;
-    return fat16_read_internal_from_stream(disk, stream, starting_cluster, offset, total, out);
+    return fat16_read_internal_from_stream(disk, stream, starting_cluster, offset, total, out, cursor);
 }
 
 void fat16_free_directory(struct fat_directory *directory)
@@ -493,11 +852,8 @@ void fat16_free_directory(struct fat_directory *directory)
 
 void fat16_fat_item_free(struct fat_item *item)
 {
-    if (item->type == FAT_ITEM_TYPE_DIRECTORY)
-    {
-        fat16_free_directory(item->directory);
-    }
-    else if (item->type == FAT_ITEM_TYPE_FILE)
+    // ADDED: Directories belong to fat_private's list, not to the item
+    if (item->type == FAT_ITEM_TYPE_FILE)
     {
         kfree(item->item);
     }
@@ -527,6 +883,7 @@ struct fat_directory *fat16_load_fat_directory(struct disk *disk, struct fat_dir
     int cluster_sector = fat16_cluster_to_sector(fat_private, cluster);
     int total_items = fat16_get_total_items_for_directory(disk, cluster_sector);
     directory->total = total_items;
+    directory->cluster = cluster;
     int directory_size = directory->total * sizeof(struct fat_directory_item);
     directory->item = kzalloc(directory_size);
     if (!directory->item)
@@ -535,19 +892,53 @@ struct fat_directory *fat16_load_fat_directory(struct disk *disk, struct fat_dir
         goto out;
     }
 
-    res = fat16_read_internal(disk, cluster, 0x00, directory_size, directory->item);
+    struct fat_cluster_cursor cursor;
+    memset(&cursor, 0, sizeof(cursor));
+    res = fat16_read_internal(disk, cluster, 0x00, directory_size, directory->item, &cursor);
     if (res != PEACHOS_ALL_OK)
     {
         goto out;
     }
 
+    telemetry_count(&fat16_directory_loads, 1);
+
 out:
     if (res != PEACHOS_ALL_OK)
     {
         fat16_free_directory(directory);
+        directory = 0;  // FIXED: Don't hand back the freed directory
+    }
+    return directory;
+}
+
+// ADDED: The directory starting at this item's cluster, read from disk the
+// first time and kept for the life of the volume
+static struct fat_directory *fat16_get_directory(struct disk *disk, struct fat_directory_item *item)
+{
+    struct fat_private *fat_private = disk->fs_private;
+    int cluster = fat16_get_first_cluster(item);
+
+    // ".." of a top level directory points at cluster 0, the root
+    if (cluster == 0)
+    {
+        return &fat_private->root_directory;
+    }
+
+    for (struct fat_directory *directory = fat_private->directories; directory; directory = directory->next)
+    {
+        if (directory->cluster == cluster)
+            return directory;
+    }
+
+    struct fat_directory *directory = fat16_load_fat_directory(disk, item);
+    if (directory)
+    {
+        directory->next = fat_private->directories;
+        fat_private->directories = directory;
     }
     return directory;
 }
+
 struct fat_item *fat16_new_fat_item_for_directory_item(struct disk *disk, struct fat_directory_item *item)
 {
     struct fat_item *f_item = kzalloc(sizeof(struct fat_item));
@@ -558,8 +949,15 @@ struct fat_item *fat16_new_fat_item_for_directory_item(struct disk *disk, struct
 
     if (item->attribute & FAT_FILE_SUBDIRECTORY)
     {
-        f_item->directory = fat16_load_fat_directory(disk, item);
+        f_item->directory = fat16_get_directory(disk, item);
         f_item->type = FAT_ITEM_TYPE_DIRECTORY;
+        // FIXED: Directories used to fall through and become files
+        if (!f_item->directory)
+        {
+            kfree(f_item);
+            return 0;
+        }
+        return f_item;
     }
 
     f_item->type = FAT_ITEM_TYPE_FILE;
@@ -567,21 +965,151 @@ struct fat_item *fat16_new_fat_item_for_directory_item(struct disk *disk, struct
     return f_item;
 }
 
+// ADDED: Case blind, like istrncmp(), so "KERNEL.BIN" and "kernel.bin"
+// land in the same bucket
+static uint32_t fat16_dentry_hash(const char *name)
+{
+    uint32_t hash = 5381;
+    while (*name)
+    {
+        hash = hash * 33 + tolower((unsigned char)*name);
+        name++;
+    }
+    return hash;
+}
+
+static void fat16_dentry_lru_remove(struct fat_dentry_cache *cache, int index)
+{
+    struct fat_dentry *entry = &cache->entries[index];
+    if (entry->prev != -1)
+        cache->entries[entry->prev].next = entry->next;
+    else
+        cache->lru_head = entry->next;
+
+    if (entry->next != -1)
+        cache->entries[entry->next].prev = entry->prev;
+    else
+        cache->lru_tail = entry->prev;
+
+    entry->prev = -1;
+    entry->next = -1;
+}
+
+static void fat16_dentry_lru_push_front(struct fat_dentry_cache *cache, int index)
+{
+    struct fat_dentry *entry = &cache->entries[index];
+    entry->prev = -1;
+    entry->next = cache->lru_head;
+    if (cache->lru_head != -1)
+        cache->entries[cache->lru_head].prev = index;
+    else
+        cache->lru_tail = index;
+
+    cache->lru_head = index;
+}
+
+static void fat16_dentry_cache_init(struct fat_dentry_cache *cache)
+{
+    for (int i = 0; i < FAT16_DENTRY_BUCKETS; i++)
+    {
+        cache->buckets[i] = -1;
+    }
+
+    cache->lru_head = -1;
+    cache->lru_tail = -1;
+    for (int i = 0; i < PEACHOS_FAT16_DENTRY_CACHE; i++)
+    {
+        cache->entries[i].valid = false;
+        cache->entries[i].hash_next = -1;
+        fat16_dentry_lru_push_front(cache, i);
+    }
+}
+
+static struct fat_dentry *fat16_dentry_lookup(struct fat_dentry_cache *cache, int parent_cluster, const char *name, uint32_t hash)
+{
+    for (int index = cache->buckets[hash % FAT16_DENTRY_BUCKETS]; index != -1; index = cache->entries[index].hash_next)
+    {
+        struct fat_dentry *entry = &cache->entries[index];
+        if (entry->hash == hash && entry->parent_cluster == parent_cluster &&
+            istrncmp(entry->name, name, FAT16_DENTRY_NAME_MAX) == 0)
+        {
+            fat16_dentry_lru_remove(cache, index);
+            fat16_dentry_lru_push_front(cache, index);
+            return entry;
+        }
+    }
+    return 0;
+}
+
+// Reuses the least recently used entry. item is 0 for a name that isn't there.
+static void fat16_dentry_insert(struct fat_dentry_cache *cache, int parent_cluster, const char *name, uint32_t hash, struct fat_directory_item *item)
+{
+    int index = cache->lru_tail;
+    struct fat_dentry *entry = &cache->entries[index];
+    if (entry->valid)
+    {
+        int *link = &cache->buckets[entry->hash % FAT16_DENTRY_BUCKETS];
+        while (*link != index)
+        {
+            link = &cache->entries[*link].hash_next;
+        }
+        *link = entry->hash_next;
+    }
+
+    entry->valid = true;
+    entry->parent_cluster = parent_cluster;
+    entry->hash = hash;
+    strncpy(entry->name, name, FAT16_DENTRY_NAME_MAX);
+    entry->negative = item == 0;
+    if (item)
+    {
+        memcpy(&entry->item, item, sizeof(struct fat_directory_item));
+    }
+
+    int bucket = hash % FAT16_DENTRY_BUCKETS;
+    entry->hash_next = cache->buckets[bucket];
+    cache->buckets[bucket] = index;
+
+    fat16_dentry_lru_remove(cache, index);
+    fat16_dentry_lru_push_front(cache, index);
+}
+
 struct fat_item *fat16_find_item_in_directory(struct disk *disk, struct fat_directory *directory, const char *name)
 {
-    struct fat_item *f_item = 0;
+    struct fat_private *fat_private = disk->fs_private;
+    struct fat_dentry_cache *cache = &fat_private->dentry_cache;
+
+    // ADDED: Names too long for 8.3 can't be in the directory at all
+    if (strnlen(name, FAT16_DENTRY_NAME_MAX) >= FAT16_DENTRY_NAME_MAX)
+    {
+        return 0;
+    }
+
+    uint32_t hash = fat16_dentry_hash(name);
+    struct fat_dentry *dentry = fat16_dentry_lookup(cache, directory->cluster, name, hash);
+    if (dentry)
+    {
+        telemetry_count(&fat16_dentry_hits, 1);
+        return dentry->negative ? 0 : fat16_new_fat_item_for_directory_item(disk, &dentry->item);
+    }
+
+    telemetry_count(&fat16_dentry_misses, 1);
+
+    struct fat_directory_item *found = 0;
     char tmp_filename[PEACHOS_MAX_PATH];
     for (int i = 0; i < directory->total; i++)
     {
         fat16_get_full_relative_filename(&directory->item[i], tmp_filename, sizeof(tmp_filename));
         if (istrncmp(tmp_filename, name, sizeof(tmp_filename)) == 0)
         {
-            // Found it let's create a new fat_item
-            f_item = fat16_new_fat_item_for_directory_item(disk, &directory->item[i]);
+            // FIXED: Stop at the first match instead of leaking earlier ones
+            found = &directory->item[i];
+            break;
         }
     }
 
-    return f_item;
+    fat16_dentry_insert(cache, directory->cluster, name, hash, found);
+    return found ? fat16_new_fat_item_for_directory_item(disk, found) : 0;
 }
 struct fat_item *fat16_get_directory_entry(struct disk *disk, struct path_part *path)
 {
@@ -629,15 +1157,35 @@ void *fat16_open(struct disk *disk, struct path_part *path, FILE_MODE mode)
     descriptor->item = fat16_get_directory_entry(disk, path);
     if (!descriptor->item)
     {
+        telemetry_log("fat16: open failed, no such entry");
         return ERROR(-EIO);
     }
 
+    telemetry_count(&fat16_opens, 1);
     descriptor->pos = 0;
+
+#if PEACHOS_FAT16_CLUSTER_RUNS
+    // ADDED: Map the clusters once; without the map (no memory, broken
+    // chain) reads fall back to walking the chain from the cursor
+    if (descriptor->item->type == FAT_ITEM_TYPE_FILE)
+    {
+        struct fat_private *private = disk->fs_private;
+        struct fat_directory_item *item = descriptor->item->item;
+        uint32_t cluster_bytes = private->header.primary_header.sectors_per_cluster * disk->sector_size;
+        uint32_t total_clusters = (item->filesize + cluster_bytes - 1) / cluster_bytes;
+        if (total_clusters > 0)
+        {
+            fat16_build_cluster_runs(disk, fat16_get_first_cluster(item), total_clusters, &descriptor->cursor);
+        }
+    }
+#endif
+
     return descriptor;
 }
 
 static void fat16_free_file_descriptor(struct fat_file_descriptor* desc)
 {
+    kfree(desc->cursor.runs);
     fat16_fat_item_free(desc->item);
     kfree(desc);
 }
@@ -680,7 +1228,7 @@ int fat16_read(struct disk *disk, void *descriptor, uint32_t size, uint32_t nmem
     int offset = fat_desc->pos;
     for (uint32_t i = 0; i < nmemb; i++)
     {
-        res = fat16_read_internal(disk, fat16_get_first_cluster(item), offset, size, out_ptr);
+        res = fat16_read_internal(disk, fat16_get_first_cluster(item), offset, size, out_ptr, &fat_desc->cursor);
         if (ISERR(res))
         {
             goto out;
@@ -690,6 +1238,10 @@ int fat16_read(struct disk *disk, void *descriptor, uint32_t size, uint32_t nmem
         offset += size;
     }
 
+    // FIXED: The next read carries on where this one stopped
+    fat_desc->pos = offset;
+    telemetry_count(&fat16_reads, 1);
+    telemetry_count(&fat16_read_bytes, size * nmemb);
     res = nmemb;
 out:
     return res;
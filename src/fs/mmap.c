@@ -0,0 +1,226 @@
+#include "mmap.h"
+#include "file.h"
+#include "config.h"
+#include "status.h"
+#include "memory/memory.h"
+#include "memory/heap/kheap.h"
+#include "memory/paging/paging.h"
+#include "telemetry/telemetry.h"
+
+// What the kernel's identity map uses; given back on unmap
+#define FMMAP_IDENTITY_FLAGS (PAGING_IS_WRITEABLE | PAGING_IS_PRESENT | PAGING_ACCESS_FROM_ALL)
+
+struct fmmap_region
+{
+    uint32_t start;
+    uint32_t pages;
+    uint32_t size;  // File bytes; the rest of the last page reads as zero
+
+    // Opened by fmmap() itself, so faults don't move the caller's position
+    int fd;
+
+    struct fmmap_region* next;
+};
+
+// Sorted by start
+static struct fmmap_region* fmmap_regions = 0;
+
+static TELEMETRY_COUNTER(fmmap_faults, "fmmap.faults");
+static TELEMETRY_COUNTER(fmmap_read_bytes, "fmmap.read_bytes");
+
+// First gap in the window that fits, and the link to put the region at
+static uint32_t fmmap_find_space(uint32_t pages, struct fmmap_region*** link_out)
+{
+    uint32_t start = PEACHOS_FMMAP_VIRTUAL_ADDRESS;
+    uint32_t end = PEACHOS_FMMAP_VIRTUAL_ADDRESS + PEACHOS_FMMAP_SIZE;
+    struct fmmap_region** link = &fmmap_regions;
+    while (*link && ((*link)->start - start) / PAGING_PAGE_SIZE < pages)
+    {
+        start = (*link)->start + (*link)->pages * PAGING_PAGE_SIZE;
+        link = &(*link)->next;
+    }
+
+    if ((end - start) / PAGING_PAGE_SIZE < pages)
+    {
+        return 0;
+    }
+
+    *link_out = link;
+    return start;
+}
+
+// Free the pages read in and put the identity map back
+static void fmmap_release(uint32_t start, uint32_t pages)
+{
+    uint32_t* directory = paging_current_directory();
+    for (uint32_t i = 0; i < pages; i++)
+    {
+        uint32_t virt = start + i * PAGING_PAGE_SIZE;
+        uint32_t entry = paging_get(directory, (void*)virt);
+        if ((entry & PAGING_IS_PRESENT) && (entry & 0xfffff000) != virt)
+        {
+            kfree((void*)(entry & 0xfffff000));
+        }
+
+        paging_set(directory, (void*)virt, virt | FMMAP_IDENTITY_FLAGS);
+        paging_invalidate((void*)virt);
+    }
+}
+
+// Make the range not present, so the first touch of each page faults
+static int fmmap_reserve(uint32_t start, uint32_t pages)
+{
+    int res = 0;
+    uint32_t* directory = paging_current_directory();
+    for (uint32_t i = 0; i < pages; i++)
+    {
+        void* virt = (void*)(start + i * PAGING_PAGE_SIZE);
+        res = paging_set(directory, virt, 0);
+        if (res < 0)
+        {
+            fmmap_release(start, i);
+            break;
+        }
+        paging_invalidate(virt);
+    }
+
+    return res;
+}
+
+void* fmmap(const char* filename, uint32_t* size_out)
+{
+    void* res = 0;
+    struct fmmap_region* region = 0;
+    int fd = fopen(filename, "r");
+    if (!fd)
+    {
+        goto out;
+    }
+
+    struct file_stat stat;
+    if (fstat(fd, &stat) < 0 || stat.filesize == 0)
+    {
+        goto out;
+    }
+
+    region = kzalloc(sizeof(struct fmmap_region));
+    if (!region)
+    {
+        goto out;
+    }
+
+    struct fmmap_region** link = 0;
+    uint32_t pages = (stat.filesize + PAGING_PAGE_SIZE - 1) / PAGING_PAGE_SIZE;
+    uint32_t start = fmmap_find_space(pages, &link);
+    if (!start || fmmap_reserve(start, pages) < 0)
+    {
+        goto out;
+    }
+
+    region->start = start;
+    region->pages = pages;
+    region->size = stat.filesize;
+    region->fd = fd;
+    region->next = *link;
+    *link = region;
+
+    if (size_out)
+    {
+        *size_out = stat.filesize;
+    }
+    res = (void*)start;
+
+out:
+    if (!res)
+    {
+        kfree(region);
+        if (fd)
+        {
+            fclose(fd);
+        }
+    }
+    return res;
+}
+
+int fmunmap(void* ptr)
+{
+    struct fmmap_region** link = &fmmap_regions;
+    while (*link && (*link)->start != (uint32_t)ptr)
+    {
+        link = &(*link)->next;
+    }
+
+    struct fmmap_region* region = *link;
+    if (!region)
+    {
+        return -EINVARG;
+    }
+
+    *link = region->next;
+    fmmap_release(region->start, region->pages);
+    fclose(region->fd);
+    kfree(region);
+    return 0;
+}
+
+int fmmap_fault(void* address)
+{
+    int res = 0;
+    uint32_t addr = (uint32_t)address;
+    struct fmmap_region* region = fmmap_regions;
+    while (region && !(addr >= region->start && addr < region->start + region->pages * PAGING_PAGE_SIZE))
+    {
+        region = region->next;
+    }
+
+    if (!region)
+    {
+        return -EINVARG;
+    }
+
+    uint32_t offset = (addr - region->start) & ~(PAGING_PAGE_SIZE - 1);
+    uint32_t bytes = region->size - offset;
+    if (bytes > PAGING_PAGE_SIZE)
+    {
+        bytes = PAGING_PAGE_SIZE;
+    }
+
+    // Heap blocks are page sized and page aligned
+    char* frame = kmalloc(PAGING_PAGE_SIZE);
+    if (!frame)
+    {
+        return -ENOMEM;
+    }
+
+    // The faulting code may be halfway through an SSE2 copy with live XMM
+    // registers, which nothing here saves
+    int path = memory_get_path();
+    if (path == MEMORY_PATH_SSE2)
+    {
+        memory_set_path(MEMORY_PATH_WORDS);
+    }
+
+    res = fseek(region->fd, offset, SEEK_SET);
+    if (res >= 0)
+    {
+        res = fread(frame, bytes, 1, region->fd);
+    }
+
+    if (res >= 0)
+    {
+        memset(frame + bytes, 0, PAGING_PAGE_SIZE - bytes);
+        res = paging_map(paging_current_directory(), (void*)(region->start + offset), frame, PAGING_IS_PRESENT | PAGING_ACCESS_FROM_ALL);
+    }
+
+    memory_set_path(path);
+
+    if (res < 0)
+    {
+        kfree(frame);
+        return res;
+    }
+
+    telemetry_count(&fmmap_faults, 1);
+    telemetry_count(&fmmap_read_bytes, bytes);
+    return 0;
+}
@@ -0,0 +1,18 @@
+#ifndef FMMAP_H
+#define FMMAP_H
+
+#include <stdint.h>
+
+// ADDED: Map a whole file into the kernel address space. Nothing is read
+// up front: each page is read through the filesystem the first time it is
+// touched, so only the pages used take memory or disk time. The mapping
+// is a private read only copy of the file. Don't pass mapped memory to
+// fread() or the disk layer; a fault there would re-enter them.
+void* fmmap(const char* filename, uint32_t* size_out);
+int fmunmap(void* ptr);
+
+// ADDED: From the page fault handler. 0 if address is in a mapping and its
+// page is now present; anything else is a real fault.
+int fmmap_fault(void* address);
+
+#endif
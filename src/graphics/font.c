@@ -0,0 +1,113 @@
+#include "font.h"
+#include "vga.h"
+
+// ADDED: Block letters, ' ' to 'Z'. Characters without a real glyph are a
+// small dot, the same thing the old per-letter rect code drew for them.
+static const uint8_t font_block_rows[][12] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // space
+    {0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x00, 0x00, 0x30, 0x30},  // '!'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '"' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '#' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '$' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '%' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '&' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '\'' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '(' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // ')' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '*' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '+' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // ',' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0xFC, 0xFC, 0x00, 0x00, 0x00, 0x00, 0x00},  // '-'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '.' (unknown - dot)
+    {0x0C, 0x0C, 0x0C, 0x0C, 0x30, 0x30, 0x30, 0x30, 0xC0, 0xC0, 0xC0, 0xC0},  // '/'
+    {0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC},  // '0'
+    {0xF0, 0xF0, 0xF0, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0xFC, 0xFC},  // '1'
+    {0xFC, 0xFC, 0x0C, 0x0C, 0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xC0, 0xFC, 0xFC},  // '2'
+    {0xFC, 0xFC, 0x0C, 0x0C, 0x0C, 0xFC, 0xFC, 0x0C, 0x0C, 0x0C, 0xFC, 0xFC},  // '3'
+    {0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C},  // '4'
+    {0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xFC, 0xFC, 0x0C, 0x0C, 0x0C, 0xFC, 0xFC},  // '5'
+    {0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC},  // '6'
+    {0xFC, 0xFC, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C},  // '7'
+    {0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC},  // '8'
+    {0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC, 0x0C, 0x0C, 0x0C, 0xFC, 0xFC},  // '9'
+    {0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00},  // ':'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // ';' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '<' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '=' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '>' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '?' (unknown - dot)
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00},  // '@' (unknown - dot)
+    {0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xCC},  // 'A'
+    {0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xF8, 0xFC, 0xCC, 0xCC, 0xCC, 0xF8, 0xF8},  // 'B'
+    {0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xFC, 0xFC},  // 'C'
+    {0xF8, 0xF8, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xF8, 0xF8},  // 'D'
+    {0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xF8, 0xF8, 0xC0, 0xC0, 0xC0, 0xFC, 0xFC},  // 'E'
+    {0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xF8, 0xF8, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0},  // 'F'
+    {0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xC0, 0xDC, 0xDC, 0xCC, 0xCC, 0xFC, 0xFC},  // 'G'
+    {0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC},  // 'H'
+    {0xFC, 0xFC, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0xFC, 0xFC},  // 'I'
+    {0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC},  // 'J'
+    {0xCC, 0xCC, 0xCC, 0xCC, 0xC0, 0xF0, 0xF0, 0xC0, 0xCC, 0xCC, 0xCC, 0xCC},  // 'K'
+    {0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0, 0xFC, 0xFC},  // 'L'
+    {0xC6, 0xC6, 0xEE, 0xEE, 0xEE, 0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0xC6},  // 'M'
+    {0xC6, 0xC6, 0xC6, 0xE6, 0xE6, 0xF6, 0xF6, 0xDE, 0xDE, 0xC6, 0xC6, 0xC6},  // 'N'
+    {0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC},  // 'O'
+    {0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xC0, 0xC0},  // 'P'
+    {0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCE, 0xFE, 0xFE},  // 'Q'
+    {0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC},  // 'R'
+    {0xFC, 0xFC, 0xC0, 0xC0, 0xC0, 0xFC, 0xFC, 0x0C, 0x0C, 0x0C, 0xFC, 0xFC},  // 'S'
+    {0xFF, 0xFF, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18},  // 'T'
+    {0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xFC, 0xFC},  // 'U'
+    {0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0x6C, 0x6C, 0x30, 0x30},  // 'V'
+    {0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0xC6, 0xEE, 0xEE, 0xEE, 0xC6, 0xC6},  // 'W'
+    {0xCC, 0xCC, 0xCC, 0xCC, 0x30, 0x30, 0x30, 0x30, 0xCC, 0xCC, 0xCC, 0xCC},  // 'X'
+    {0xCC, 0xCC, 0xCC, 0xCC, 0xCC, 0xFC, 0x78, 0x30, 0x30, 0x30, 0x30, 0x30},  // 'Y'
+    {0xFC, 0xFC, 0x0C, 0x0C, 0x0C, 0x30, 0x30, 0xC0, 0xC0, 0xC0, 0xFC, 0xFC},  // 'Z'
+};
+
+// ADDED: 5x7 digits 0-9
+static const uint8_t font_digit_rows[][7] = {
+    {0xF8, 0x88, 0x88, 0x88, 0x88, 0x88, 0xF8},  // 0
+    {0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0xF8},  // 1
+    {0xF8, 0x08, 0x08, 0xF8, 0x80, 0x80, 0xF8},  // 2
+    {0xF8, 0x08, 0x08, 0xF8, 0x08, 0x08, 0xF8},  // 3
+    {0x88, 0x88, 0x88, 0xF8, 0x08, 0x08, 0x08},  // 4
+    {0xF8, 0x80, 0x80, 0xF8, 0x08, 0x08, 0xF8},  // 5
+    {0xF8, 0x80, 0x80, 0xF8, 0x88, 0x88, 0xF8},  // 6
+    {0xF8, 0x08, 0x08, 0x10, 0x20, 0x40, 0x80},  // 7
+    {0xF8, 0x88, 0x88, 0xF8, 0x88, 0x88, 0xF8},  // 8
+    {0xF8, 0x88, 0x88, 0xF8, 0x08, 0x08, 0xF8},  // 9
+};
+
+const struct font font_block = {12, 8, ' ', 'Z', '.', &font_block_rows[0][0]};
+const struct font font_digits = {7, 6, '0', '9', '0', &font_digit_rows[0][0]};
+
+void font_draw_char(const struct font* font, int x, int y, char c, int scale, uint8_t color)
+{
+    // ADDED: The block font only has capitals
+    if (c >= 'a' && c <= 'z' && font->last < 'a')
+    {
+        c = c - 32;
+    }
+
+    if (c < font->first || c > font->last)
+    {
+        c = font->fallback;
+    }
+
+    const uint8_t* rows = font->rows + (c - font->first) * font->height;
+    vga_draw_bitmap(x, y, rows, font->height, scale, color);
+}
+
+void font_draw_text(const struct font* font, int x, int y, const char* text, int scale, uint8_t color)
+{
+    for (int i = 0; text[i] != '\0'; i++)
+    {
+        // ADDED: Spaces only move the cursor
+        if (text[i] != ' ')
+        {
+            font_draw_char(font, x, y, text[i], scale, color);
+        }
+        x += font->advance * scale;
+    }
+}
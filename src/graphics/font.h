@@ -0,0 +1,30 @@
+#ifndef FONT_H
+#define FONT_H
+
+#include <stdint.h>
+
+// ADDED: 1-bpp bitmap font. Each glyph is `height` bytes, one per row,
+// bit 7 = leftmost pixel, so glyphs are at most 8 pixels wide.
+struct font
+{
+    int height;
+    int advance;         // Cursor step between characters
+    char first;          // First character in the table
+    char last;           // Last character in the table
+    char fallback;       // Drawn for characters outside the table
+    const uint8_t* rows;
+};
+
+// ADDED: 8x12 block letters (menus, level screens, countdown)
+extern const struct font font_block;
+
+// ADDED: 5x7 digits (HUD numbers)
+extern const struct font font_digits;
+
+// ADDED: Draw one character, each font pixel as a scale x scale block
+void font_draw_char(const struct font* font, int x, int y, char c, int scale, uint8_t color);
+
+// ADDED: Draw a string left to right starting at (x, y)
+void font_draw_text(const struct font* font, int x, int y, const char* text, int scale, uint8_t color);
+
+#endif
@@ -2,8 +2,149 @@
 #include "io/io.h"
 #include "memory/memory.h"
 
-// ADDED: Pointer to VGA memory
+// ADDED: Pointer to VGA memory. The host build (make host) has no video
+// memory, so frames are presented into a plain array instead.
+#ifdef PEACHOS_HOST
+static uint8_t vga_host_memory[0x10000];
+static uint8_t* vga_memory = vga_host_memory;
+#else
 static uint8_t* vga_memory = (uint8_t*)VGA_MEMORY;
+#endif
+
+// ADDED: Off-screen back buffer in normal RAM. All drawing lands here and
+// vga_present() pushes the finished frame to 0xA0000 in one pass, so the
+// screen never shows a half-drawn frame.
+static uint8_t vga_back_buffer[VGA_WIDTH * VGA_HEIGHT] __attribute__((aligned(4)));
+
+// ADDED: The back buffer seen through the surface API
+static struct vga_surface vga_back_surface = {vga_back_buffer, VGA_WIDTH, VGA_HEIGHT};
+
+// ADDED: Regions of the back buffer changed since the last present
+static struct vga_rect vga_dirty_rects[VGA_MAX_DIRTY_RECTS];
+static int vga_dirty_count = 0;
+static uint32_t vga_present_bytes = 0;
+static bool vga_vsync = false;
+
+// ADDED: Unchained mode state. The damage presented last frame only made it
+// to the page that is now in front, so it has to be carried over to the
+// other page before that one is shown.
+static bool vga_unchained = false;
+static int vga_front_page = 0;
+static struct vga_rect vga_prev_rects[VGA_MAX_DIRTY_RECTS];
+static int vga_prev_count = 0;
+
+// ADDED: Fill count bytes with the color replicated in pattern. Byte stores
+// up to a 4-byte boundary, then rep stosd for the bulk, then the tail.
+static inline void vga_fill_span(uint8_t* dst, int count, uint32_t pattern)
+{
+    while (count > 0 && ((uintptr_t)dst & 3))
+    {
+        *dst++ = (uint8_t)pattern;
+        count--;
+    }
+
+    int words = count >> 2;
+    if (words > 0)
+    {
+        __asm__ volatile("rep stosl" : "+D"(dst), "+c"(words) : "a"(pattern) : "memory");
+    }
+
+    count &= 3;
+    while (count-- > 0)
+    {
+        *dst++ = (uint8_t)pattern;
+    }
+}
+
+// ADDED: Copy whole 32-bit words (rep movsd)
+static inline void vga_copy_words(volatile void* dst, const void* src, int words)
+{
+    __asm__ volatile("rep movsl" : "+D"(dst), "+S"(src), "+c"(words) : : "memory");
+}
+
+// ADDED: Copy count bytes - whole words with rep movsd, then the tail
+static inline void vga_copy_span(uint8_t* dst, const uint8_t* src, int count)
+{
+    int words = count >> 2;
+    if (words > 0)
+    {
+        __asm__ volatile("rep movsl" : "+D"(dst), "+S"(src), "+c"(words) : : "memory");
+    }
+
+    count &= 3;
+    while (count-- > 0)
+    {
+        *dst++ = *src++;
+    }
+}
+
+static bool vga_rects_touch(struct vga_rect* a, struct vga_rect* b)
+{
+    // ADDED: Overlapping or directly adjacent rectangles get merged
+    return a->x <= b->x + b->width && b->x <= a->x + a->width &&
+           a->y <= b->y + b->height && b->y <= a->y + a->height;
+}
+
+static struct vga_rect vga_rect_union(struct vga_rect* a, struct vga_rect* b)
+{
+    struct vga_rect r;
+    int x2 = (a->x + a->width > b->x + b->width) ? a->x + a->width : b->x + b->width;
+    int y2 = (a->y + a->height > b->y + b->height) ? a->y + a->height : b->y + b->height;
+    r.x = (a->x < b->x) ? a->x : b->x;
+    r.y = (a->y < b->y) ? a->y : b->y;
+    r.width = x2 - r.x;
+    r.height = y2 - r.y;
+    return r;
+}
+
+void vga_mark_dirty(int x, int y, int width, int height)
+{
+    // ADDED: Clip to the screen
+    if (x < 0) { width += x; x = 0; }
+    if (y < 0) { height += y; y = 0; }
+    if (x + width > VGA_WIDTH) width = VGA_WIDTH - x;
+    if (y + height > VGA_HEIGHT) height = VGA_HEIGHT - y;
+    if (width <= 0 || height <= 0)
+        return;
+
+    struct vga_rect r = {x, y, width, height};
+
+    // ADDED: Absorb every rectangle the new one touches. The merged result
+    // can touch rectangles we already skipped, so rescan after each merge.
+    int i = 0;
+    while (i < vga_dirty_count)
+    {
+        if (vga_rects_touch(&r, &vga_dirty_rects[i]))
+        {
+            r = vga_rect_union(&r, &vga_dirty_rects[i]);
+            vga_dirty_rects[i] = vga_dirty_rects[--vga_dirty_count];
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+
+    if (vga_dirty_count < VGA_MAX_DIRTY_RECTS)
+    {
+        vga_dirty_rects[vga_dirty_count++] = r;
+        return;
+    }
+
+    // ADDED: List is full - grow whichever rectangle gains the least area
+    int best = 0;
+    int best_growth = 0x7FFFFFFF;
+    for (i = 0; i < vga_dirty_count; i++)
+    {
+        struct vga_rect u = vga_rect_union(&r, &vga_dirty_rects[i]);
+        int growth = u.width * u.height - vga_dirty_rects[i].width * vga_dirty_rects[i].height;
+        if (growth < best_growth)
+        {
+            best_growth = growth;
+            best = i;
+        }
+    }
+    vga_dirty_rects[best] = vga_rect_union(&r, &vga_dirty_rects[best]);
+}
 
 void vga_init()
 {
@@ -11,12 +152,13 @@ void vga_init()
     // To get to mode 0x13, we need to use BIOS INT 0x10
     // But we're in protected mode, so we'll use a trick:
     // Write mode 13h setup directly
-    
+
     // SIMPLE METHOD: Just assume mode 13h is set
     // (We'll do this properly in a moment)
-    
+
     // For now, clear the screen
     vga_clear(0);
+    vga_present();
 }
 
 void vga_set_pixel(int x, int y, uint8_t color)
@@ -24,29 +166,210 @@ void vga_set_pixel(int x, int y, uint8_t color)
     // ADDED: Bounds check
     if (x < 0 || x >= VGA_WIDTH || y < 0 || y >= VGA_HEIGHT)
         return;
-    
+
     // ADDED: Calculate offset and write pixel
-    vga_memory[y * VGA_WIDTH + x] = color;
+    vga_back_buffer[y * VGA_WIDTH + x] = color;
+    vga_mark_dirty(x, y, 1, 1);
 }
 
 void vga_clear(uint8_t color)
 {
-    // ADDED: Direct loop instead of memset (more reliable)
-    uint8_t* vga = (uint8_t*)0xA0000;
-    for (int i = 0; i < VGA_WIDTH * VGA_HEIGHT; i++)
+    // ADDED: One rep stosd over the whole back buffer
+    vga_fill_span(vga_back_buffer, VGA_WIDTH * VGA_HEIGHT, color * 0x01010101u);
+    vga_mark_dirty(0, 0, VGA_WIDTH, VGA_HEIGHT);
+}
+
+void vga_draw_frame(uint8_t* framebuffer)
+{
+    // ADDED: Video memory isn't linear when unchained - go through the
+    // back buffer and the planar present instead
+    if (vga_unchained)
     {
-        vga[i] = color;
+        vga_copy_words(vga_back_buffer, framebuffer, (VGA_WIDTH * VGA_HEIGHT) / 4);
+        vga_mark_dirty(0, 0, VGA_WIDTH, VGA_HEIGHT);
+        vga_present();
+        return;
     }
+
+    // ADDED: Copy a whole frame to VGA memory with 32-bit stores
+    // (16,000 bus writes instead of 64,000)
+    vga_copy_words(vga_memory, framebuffer, (VGA_WIDTH * VGA_HEIGHT) / 4);
 }
 
-void vga_draw_frame(uint8_t* framebuffer)
+void vga_wait_retrace()
+{
+    // ADDED: If we're already inside a retrace, let it finish first so we
+    // always catch the beginning of one (the whole blanking interval)
+    while (insb(VGA_INPUT_STATUS) & VGA_STATUS_VRETRACE)
+    {
+    }
+    while (!(insb(VGA_INPUT_STATUS) & VGA_STATUS_VRETRACE))
+    {
+    }
+}
+
+void vga_set_vsync(bool enabled)
+{
+    vga_vsync = enabled;
+}
+
+bool vga_get_vsync()
+{
+    return vga_vsync;
+}
+
+static void vga_set_start_address(uint16_t offset)
+{
+    outw(VGA_CRTC_INDEX, (offset & 0xFF00) | 0x0C);
+    outw(VGA_CRTC_INDEX, ((offset & 0x00FF) << 8) | 0x0D);
+}
+
+static void vga_present_unchained()
+{
+    int back_page = vga_front_page ^ 1;
+    volatile uint8_t* front = vga_memory + vga_front_page * VGA_PAGE_SIZE;
+    volatile uint8_t* back = vga_memory + back_page * VGA_PAGE_SIZE;
+
+    vga_present_bytes = 0;
+
+    // ADDED: Last frame's changes are on the front page only. Copy them
+    // across inside video memory: in write mode 1 a read loads all four
+    // planes into the latches and a write stores them, 4 pixels a byte.
+    outw(VGA_GC_INDEX, 0x4105);
+    outw(VGA_SEQ_INDEX, 0x0F02);
+    for (int i = 0; i < vga_prev_count; i++)
+    {
+        struct vga_rect* r = &vga_prev_rects[i];
+        int bx0 = r->x >> 2;
+        int bx1 = (r->x + r->width + 3) >> 2;
+        for (int y = r->y; y < r->y + r->height; y++)
+        {
+            int offset = y * VGA_PLANE_PITCH;
+            for (int bx = bx0; bx < bx1; bx++)
+            {
+                back[offset + bx] = front[offset + bx];
+            }
+        }
+        vga_present_bytes += (uint32_t)(bx1 - bx0) * r->height;
+    }
+    outw(VGA_GC_INDEX, 0x4005);
+
+    // ADDED: This frame's changes come from the back buffer, one plane
+    // (every 4th pixel) at a time
+    for (int plane = 0; plane < 4; plane++)
+    {
+        outw(VGA_SEQ_INDEX, ((1 << plane) << 8) | 0x02);
+        for (int i = 0; i < vga_dirty_count; i++)
+        {
+            struct vga_rect* r = &vga_dirty_rects[i];
+            int bx0 = r->x >> 2;
+            int bx1 = (r->x + r->width + 3) >> 2;
+            for (int y = r->y; y < r->y + r->height; y++)
+            {
+                const uint8_t* src = vga_back_buffer + y * VGA_WIDTH + plane;
+                volatile uint8_t* dst = back + y * VGA_PLANE_PITCH;
+                for (int bx = bx0; bx < bx1; bx++)
+                {
+                    dst[bx] = src[bx * 4];
+                }
+            }
+            vga_present_bytes += (uint32_t)(bx1 - bx0) * r->height;
+        }
+    }
+
+    // ADDED: Show the new page. The start address is latched at the next
+    // retrace; once that begins the old page is hidden and free to draw.
+    // With vsync off (benchmark runs) the flip isn't waited for and the
+    // next frame may tear.
+    vga_set_start_address(back_page * VGA_PAGE_SIZE);
+    if (vga_vsync)
+    {
+        vga_wait_retrace();
+    }
+    vga_front_page = back_page;
+
+    for (int i = 0; i < vga_dirty_count; i++)
+    {
+        vga_prev_rects[i] = vga_dirty_rects[i];
+    }
+    vga_prev_count = vga_dirty_count;
+    vga_dirty_count = 0;
+}
+
+void vga_set_unchained(bool enabled)
+{
+    if (enabled == vga_unchained)
+        return;
+
+    if (enabled)
+    {
+        // ADDED: Chain-4 off (planes addressed separately), then have the
+        // CRTC scan memory as bytes instead of doublewords
+        outw(VGA_SEQ_INDEX, 0x0604);
+        outw(VGA_CRTC_INDEX, 0x0014);
+        outw(VGA_CRTC_INDEX, 0xE317);
+    }
+    else
+    {
+        // ADDED: Back to the mode 13h defaults
+        outw(VGA_SEQ_INDEX, 0x0E04);
+        outw(VGA_CRTC_INDEX, 0x4014);
+        outw(VGA_CRTC_INDEX, 0xA317);
+    }
+
+    vga_unchained = enabled;
+    vga_front_page = 0;
+    vga_prev_count = 0;
+    vga_set_start_address(0);
+
+    // ADDED: Memory layout changed under us - put the whole frame back.
+    // Unchained, the other page then picks it up through the latch copy.
+    vga_mark_dirty(0, 0, VGA_WIDTH, VGA_HEIGHT);
+    vga_present();
+}
+
+bool vga_get_unchained()
 {
-    // ADDED: Direct loop instead of memcpy
-    uint8_t* vga = (uint8_t*)0xA0000;
-    for (int i = 0; i < VGA_WIDTH * VGA_HEIGHT; i++)
+    return vga_unchained;
+}
+
+void vga_present()
+{
+    if (vga_unchained)
     {
-        vga[i] = framebuffer[i];
+        vga_present_unchained();
+        return;
     }
+
+    if (vga_vsync)
+    {
+        vga_wait_retrace();
+    }
+
+    // ADDED: Only the touched regions travel over the bus. Each rectangle is
+    // widened to 4-pixel boundaries so every row is whole 32-bit stores.
+    vga_present_bytes = 0;
+    for (int i = 0; i < vga_dirty_count; i++)
+    {
+        struct vga_rect* r = &vga_dirty_rects[i];
+        int x0 = r->x & ~3;
+        int x1 = (r->x + r->width + 3) & ~3;
+        int words = (x1 - x0) / 4;
+
+        for (int y = r->y; y < r->y + r->height; y++)
+        {
+            int offset = y * VGA_WIDTH + x0;
+            vga_copy_words(vga_memory + offset, vga_back_buffer + offset, words);
+        }
+        vga_present_bytes += (uint32_t)(x1 - x0) * r->height;
+    }
+
+    vga_dirty_count = 0;
+}
+
+uint32_t vga_get_present_bytes()
+{
+    return vga_present_bytes;
 }
 
 void vga_set_palette(uint8_t index, uint8_t r, uint8_t g, uint8_t b)
@@ -58,18 +381,123 @@ void vga_set_palette(uint8_t index, uint8_t r, uint8_t g, uint8_t b)
     outb(0x3C9, b >> 2);
 }
 
+void vga_surface_fill_rect(struct vga_surface* surface, int x, int y, int width, int height, uint8_t color)
+{
+    // ADDED: Clip once, then one span per scanline
+    int x0 = (x < 0) ? 0 : x;
+    int y0 = (y < 0) ? 0 : y;
+    int x1 = (x + width > surface->width) ? surface->width : x + width;
+    int y1 = (y + height > surface->height) ? surface->height : y + height;
+    if (x0 >= x1 || y0 >= y1)
+        return;
+
+    uint32_t pattern = color * 0x01010101u;
+    uint8_t* row = surface->pixels + y0 * surface->width + x0;
+    for (int py = y0; py < y1; py++)
+    {
+        vga_fill_span(row, x1 - x0, pattern);
+        row += surface->width;
+    }
+}
+
+void vga_surface_outline_rect(struct vga_surface* surface, int x, int y, int width, int height, int thickness, uint8_t color)
+{
+    // ADDED: Border as four filled strips instead of per-pixel loops
+    if (thickness * 2 >= width || thickness * 2 >= height)
+    {
+        vga_surface_fill_rect(surface, x, y, width, height, color);
+        return;
+    }
+
+    vga_surface_fill_rect(surface, x, y, width, thickness, color);
+    vga_surface_fill_rect(surface, x, y + height - thickness, width, thickness, color);
+    vga_surface_fill_rect(surface, x, y + thickness, thickness, height - 2 * thickness, color);
+    vga_surface_fill_rect(surface, x + width - thickness, y + thickness, thickness, height - 2 * thickness, color);
+}
+
 void vga_fill_rect(int x, int y, int width, int height, uint8_t color)
 {
-    for (int dy = 0; dy < height; dy++)
+    vga_surface_fill_rect(&vga_back_surface, x, y, width, height, color);
+    vga_mark_dirty(x, y, width, height);
+}
+
+void vga_outline_rect(int x, int y, int width, int height, int thickness, uint8_t color)
+{
+    vga_surface_outline_rect(&vga_back_surface, x, y, width, height, thickness, color);
+    vga_mark_dirty(x, y, width, height);
+}
+
+void vga_blit(struct vga_surface* src, int src_x, int src_y, int x, int y, int width, int height)
+{
+    // ADDED: Clip against the source surface...
+    if (src_x < 0) { x -= src_x; width += src_x; src_x = 0; }
+    if (src_y < 0) { y -= src_y; height += src_y; src_y = 0; }
+    if (src_x + width > src->width) width = src->width - src_x;
+    if (src_y + height > src->height) height = src->height - src_y;
+
+    // ADDED: ...and against the screen
+    if (x < 0) { src_x -= x; width += x; x = 0; }
+    if (y < 0) { src_y -= y; height += y; y = 0; }
+    if (x + width > VGA_WIDTH) width = VGA_WIDTH - x;
+    if (y + height > VGA_HEIGHT) height = VGA_HEIGHT - y;
+    if (width <= 0 || height <= 0)
+        return;
+
+    const uint8_t* from = src->pixels + src_y * src->width + src_x;
+    uint8_t* to = vga_back_buffer + y * VGA_WIDTH + x;
+    for (int row = 0; row < height; row++)
+    {
+        vga_copy_span(to, from, width);
+        from += src->width;
+        to += VGA_WIDTH;
+    }
+    vga_mark_dirty(x, y, width, height);
+}
+
+void vga_draw_bitmap(int x, int y, const uint8_t* rows, int height, int scale, uint8_t color)
+{
+    int width = 8 * scale;
+    bool inside = x >= 0 && y >= 0 && x + width <= VGA_WIDTH && y + height * scale <= VGA_HEIGHT;
+    uint32_t pattern = color * 0x01010101u;
+
+    for (int row = 0; row < height; row++)
     {
-        for (int dx = 0; dx < width; dx++)
+        uint8_t bits = rows[row];
+        int py = y + row * scale;
+
+        // ADDED: Each run of set bits is one span per output scanline
+        int col = 0;
+        while (bits)
         {
-            int px = x + dx;
-            int py = y + dy;
-            if (px >= 0 && px < 320 && py >= 0 && py < 200)
+            while (!(bits & 0x80))
+            {
+                bits <<= 1;
+                col++;
+            }
+            int start = col;
+            while (bits & 0x80)
+            {
+                bits <<= 1;
+                col++;
+            }
+
+            int px = x + start * scale;
+            int run = (col - start) * scale;
+            if (inside)
+            {
+                uint8_t* dst = vga_back_buffer + py * VGA_WIDTH + px;
+                for (int s = 0; s < scale; s++)
+                {
+                    vga_fill_span(dst, run, pattern);
+                    dst += VGA_WIDTH;
+                }
+            }
+            else
             {
-                vga_set_pixel(px, py, color);
+                vga_surface_fill_rect(&vga_back_surface, px, py, run, scale, color);
             }
         }
     }
-}
\ No newline at end of file
+
+    vga_mark_dirty(x, y, width, height * scale);
+}
@@ -9,21 +9,102 @@
 #define VGA_HEIGHT 200
 #define VGA_MEMORY 0xA0000
 
+// ADDED: Max separate dirty regions tracked per frame (overflow gets merged)
+#define VGA_MAX_DIRTY_RECTS 32
+
+// ADDED: Input status register 1; bit 3 is set during vertical retrace
+#define VGA_INPUT_STATUS 0x3DA
+#define VGA_STATUS_VRETRACE 0x08
+
+// ADDED: Register index/data port pairs
+#define VGA_SEQ_INDEX  0x3C4
+#define VGA_GC_INDEX   0x3CE
+#define VGA_CRTC_INDEX 0x3D4
+
+// ADDED: Unchained (planar) 320x200: each plane holds every 4th pixel, so
+// one page is 80 bytes x 200 lines and video memory fits several pages
+#define VGA_PLANE_PITCH (VGA_WIDTH / 4)
+#define VGA_PAGE_SIZE   (VGA_PLANE_PITCH * VGA_HEIGHT)
+#define VGA_PAGE_COUNT  2
+
+struct vga_rect
+{
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// ADDED: Off-screen 8-bit image in the same format as the screen, for
+// content that is drawn once and copied in many times
+struct vga_surface
+{
+    uint8_t* pixels;
+    int width;
+    int height;
+};
+
 // ADDED: Initialize VGA Mode 13h (320x200, 256 colors)
 void vga_init();
 
-// ADDED: Set a single pixel
+// ADDED: Set a single pixel (in the back buffer)
 void vga_set_pixel(int x, int y, uint8_t color);
 
-// ADDED: Clear screen to a color
+// ADDED: Clear the back buffer to a color
 void vga_clear(uint8_t color);
 
 // ADDED: Draw entire framebuffer (for DoomGeneric)
 void vga_draw_frame(uint8_t* framebuffer);
 
+// ADDED: Copy the regions touched since the last present to the screen
+// (call once per finished frame)
+void vga_present();
+
+// ADDED: Block until the start of the next vertical retrace
+void vga_wait_retrace();
+
+// ADDED: When enabled, vga_present() waits for vertical retrace before
+// copying, so the copy lands while the beam is off screen (no tearing)
+// and presents run at the display refresh (70 Hz in mode 13h)
+void vga_set_vsync(bool enabled);
+bool vga_get_vsync();
+
+// ADDED: Switch between normal mode 13h and unchained 320x200 with two
+// pages in video memory. Unchained, vga_present() brings the hidden page
+// up to date and flips to it with a start-address write, then (with vsync
+// on) waits for retrace so the old page is off screen before it is drawn
+// into again.
+void vga_set_unchained(bool enabled);
+bool vga_get_unchained();
+
+// ADDED: Record a changed region of the back buffer. Drawing calls do this
+// themselves; only needed after writing the back buffer some other way.
+void vga_mark_dirty(int x, int y, int width, int height);
+
+// ADDED: Bytes copied to VGA memory by the last vga_present()
+uint32_t vga_get_present_bytes();
+
 // ADDED: Set VGA palette entry
 void vga_set_palette(uint8_t index, uint8_t r, uint8_t g, uint8_t b);
 
+// ADDED: Filled rectangle, clipped to the screen once and drawn as one
+// span per scanline
 void vga_fill_rect(int x, int y, int width, int height, uint8_t color);
 
+// ADDED: Hollow rectangle with a border `thickness` pixels wide
+void vga_outline_rect(int x, int y, int width, int height, int thickness, uint8_t color);
+
+// ADDED: Same as above, drawn into an off-screen surface instead
+void vga_surface_fill_rect(struct vga_surface* surface, int x, int y, int width, int height, uint8_t color);
+void vga_surface_outline_rect(struct vga_surface* surface, int x, int y, int width, int height, int thickness, uint8_t color);
+
+// ADDED: Copy a width x height block starting at (src_x, src_y) in a surface
+// to (x, y) in the back buffer. Clipped against both.
+void vga_blit(struct vga_surface* src, int src_x, int src_y, int x, int y, int width, int height);
+
+// ADDED: Draw a 1-bpp bitmap, 8 pixels wide and `height` rows (bit 7 is
+// the leftmost pixel), in one color. Every bitmap pixel becomes a
+// scale x scale block; clear bits are left untouched.
+void vga_draw_bitmap(int x, int y, const uint8_t* rows, int height, int scale, uint8_t color);
+
 #endif
\ No newline at end of file
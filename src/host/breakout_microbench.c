@@ -0,0 +1,191 @@
+/*
+ * breakout_microbench.c - Game update and render timings on the host
+ *
+ * Built by make host (run with make host-bench). For each scenario the
+ * game is set up with a given number of balls, particles, power-ups and
+ * lasers, then stepped and drawn frame after frame. Printed per frame:
+ * - update:  breakout_update(), one 16 ms game step
+ * - render:  breakout_render() as the game does it (only what changed)
+ * - full:    breakout_render() after render_invalidate() (whole screen)
+ * - present: vga_present() into the fake video memory
+ *
+ * The objects fly off or die after a while, so the game is set up again
+ * every BATCH_FRAMES frames (not timed). Usage: breakout_microbench [frames]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "graphics/vga.h"
+#include "timer/timer.h"
+#include "breakout/breakout.h"
+
+extern game_state_t game;
+
+#define DEFAULT_FRAMES 20000
+#define BATCH_FRAMES 30
+
+struct scenario
+{
+    const char* name;
+    int balls;
+    int particles;
+    int powerups;
+    int lasers;
+};
+
+static const struct scenario scenarios[] = {
+    {"1 ball",                 1,         0,             0,            0},
+    {"3 balls, 30 particles",  3,         30,            3,            4},
+    {"10 balls, 100 particles", MAX_BALLS, MAX_PARTICLES, MAX_POWERUPS, MAX_LASERS},
+};
+
+#define SCENARIO_COUNT (int)(sizeof(scenarios) / sizeof(scenarios[0]))
+
+struct timings
+{
+    uint64_t update_ns;
+    uint64_t render_ns;
+    uint64_t full_ns;
+    uint64_t present_ns;
+};
+
+static uint64_t now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+/*
+ * setup - Fresh game with the scenario's objects in play
+ *
+ * Everything is placed the same way every time (fixed seed, fixed
+ * positions) so runs can be compared.
+ */
+static void setup(const struct scenario* s)
+{
+    random_seed(12345);
+    breakout_init(1);
+    game.players[0].lives = 1000;
+
+    for (int i = 0; i < s->balls; i++)
+    {
+        ball_t* ball = &game.balls[i];
+        ball->active = true;
+        ball->x = 30 + i * 26;
+        ball->y = 110 + (i % 3) * 12;
+        ball->dx = (i & 1) ? 2 : -2;
+        ball->dy = -2 - (i % 2);
+        ball->trail_index = 0;
+        for (int j = 0; j < BALL_TRAIL_LENGTH; j++)
+        {
+            ball->trail_x[j] = ball->x;
+            ball->trail_y[j] = ball->y;
+        }
+    }
+
+    for (int i = 0; i < s->particles; i++)
+    {
+        particle_t* particle = &game.particles[i];
+        particle->active = true;
+        particle->x = 20 + (i * 37) % 280;
+        particle->y = 90 + (i * 13) % 60;
+        particle->dx = (i % 5) - 2;
+        particle->dy = -1 - (i % 4);
+        particle->color = 1 + i % 15;
+        particle->lifetime = BATCH_FRAMES + 10;
+    }
+
+    for (int i = 0; i < s->powerups; i++)
+    {
+        game.powerups[i].active = true;
+        game.powerups[i].x = 15 + i * 30;
+        game.powerups[i].y = 100 + (i % 4) * 8;
+        game.powerups[i].type = (powerup_type_t)(1 + i % 7);
+    }
+
+    for (int i = 0; i < s->lasers; i++)
+    {
+        game.lasers[i].active = true;
+        game.lasers[i].x = 12 + i * 15;
+        game.lasers[i].y = 170 - (i % 5) * 6;
+    }
+
+    // Start the batch from a presented screen, like the game does
+    render_invalidate();
+    breakout_render();
+    vga_present();
+}
+
+static void run(const struct scenario* s, int frames, struct timings* t)
+{
+    t->update_ns = t->render_ns = t->full_ns = t->present_ns = 0;
+
+    // Incremental frames: update, render what changed, present
+    for (int done = 0; done < frames; done += BATCH_FRAMES)
+    {
+        setup(s);
+        for (int f = 0; f < BATCH_FRAMES; f++)
+        {
+            uint64_t t0 = now_ns();
+            breakout_update();
+            uint64_t t1 = now_ns();
+            breakout_render();
+            uint64_t t2 = now_ns();
+            vga_present();
+            uint64_t t3 = now_ns();
+
+            t->update_ns += t1 - t0;
+            t->render_ns += t2 - t1;
+            t->present_ns += t3 - t2;
+        }
+    }
+
+    // Whole-screen redraws of the same frames
+    for (int done = 0; done < frames; done += BATCH_FRAMES)
+    {
+        setup(s);
+        for (int f = 0; f < BATCH_FRAMES; f++)
+        {
+            breakout_update();
+            render_invalidate();
+            uint64_t t0 = now_ns();
+            breakout_render();
+            t->full_ns += now_ns() - t0;
+            vga_present();
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int frames = (argc > 1) ? atoi(argv[1]) : DEFAULT_FRAMES;
+    if (frames < BATCH_FRAMES)
+    {
+        frames = BATCH_FRAMES;
+    }
+    frames -= frames % BATCH_FRAMES;
+
+    timer_init();
+    vga_set_vsync(false);
+
+    printf("%d frames per scenario, ns/frame\n", frames);
+    printf("%-26s %10s %10s %10s %10s\n", "scenario", "update", "render", "full", "present");
+
+    for (int i = 0; i < SCENARIO_COUNT; i++)
+    {
+        struct timings t;
+        run(&scenarios[i], frames, &t);
+        printf("%-26s %10llu %10llu %10llu %10llu\n", scenarios[i].name,
+               (unsigned long long)(t.update_ns / frames),
+               (unsigned long long)(t.render_ns / frames),
+               (unsigned long long)(t.full_ns / frames),
+               (unsigned long long)(t.present_ns / frames));
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * host_platform.c - The hardware layer for the host build (make host)
+ *
+ * The game code (breakout_game.c and the files it calls into), the VGA
+ * back buffer code, the font, keyboard buffer and profiler build natively
+ * on the development machine. What they expect from the machine comes
+ * from here instead:
+ * - Port I/O does nothing, except that the VGA status register toggles
+ *   its retrace bit so retrace waits return
+ * - The clock is CLOCK_MONOTONIC: "cycles" are nanoseconds
+ * - Key presses come from keyboard_inject()
+ * - Video memory is a plain array inside vga.c (PEACHOS_HOST)
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "io/io.h"
+#include "timer/timer.h"
+
+#define HOST_VGA_INPUT_STATUS 0x3DA
+
+/* PORT I/O */
+
+unsigned char insb(unsigned short port)
+{
+    static unsigned char status = 0;
+
+    if (port == HOST_VGA_INPUT_STATUS)
+    {
+        status ^= 0x08;
+        return status;
+    }
+    return 0;
+}
+
+unsigned short insw(unsigned short port)
+{
+    return 0;
+}
+
+void outb(unsigned short port, unsigned char val)
+{
+}
+
+void outw(unsigned short port, unsigned short val)
+{
+}
+
+/* CLOCK */
+
+static uint64_t host_now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static uint64_t host_start_ns = 0;
+
+void timer_init()
+{
+    host_start_ns = host_now_ns();
+}
+
+uint32_t timer_get_ticks()
+{
+    return (uint32_t)((host_now_ns() - host_start_ns) / 1000000ull);
+}
+
+void timer_wait(uint32_t ms)
+{
+    uint32_t start = timer_get_ticks();
+    while (timer_get_ticks() - start < ms)
+    {
+    }
+}
+
+uint32_t timer_udiv64(uint64_t dividend, uint32_t divisor)
+{
+    uint64_t quotient = dividend / divisor;
+    return quotient > 0xFFFFFFFFull ? 0xFFFFFFFF : (uint32_t)quotient;
+}
+
+uint32_t timer_get_cycles()
+{
+    return (uint32_t)host_now_ns();
+}
+
+uint32_t timer_get_cycles_per_ms()
+{
+    return 1000000;
+}
+
+uint32_t timer_cycles_to_us(uint32_t cycles)
+{
+    return cycles / 1000;
+}
+
+/* KERNEL LIBRARY */
+
+// Same behaviour as stdlib/stdlib.c (the profiler formats numbers with it)
+void itoa(int value, char* buffer)
+{
+    sprintf(buffer, "%d", value);
+}
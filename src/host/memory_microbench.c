@@ -0,0 +1,160 @@
+/*
+ * memory_microbench.c - mem* throughput of each memory path on the host
+ *
+ * Built by make host (run with make host-bench). src/memory/memory.c is
+ * linked in as is, so its memcpy/memset/memmove/memcmp replace the C
+ * library's for this program. For each size every path that the CPU has
+ * (see memory_set_path()) is timed on:
+ * - memcpy:  aligned buffers
+ * - memcpy+1: source one byte off, the case the prologue can't fix
+ * - memset
+ * - memmove: destination 8 bytes above the source (backward copy)
+ * - memcmp:  equal buffers, so the whole size is compared
+ *
+ * Results are MB/s. Each measurement moves about DEFAULT_MB_PER_RUN MB.
+ * Usage: memory_microbench [megabytes per run]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "memory/memory.h"
+
+#define DEFAULT_MB_PER_RUN 64
+#define BUFFER_SIZE (4 * 1024 * 1024 + 64)
+
+enum
+{
+    OP_COPY,
+    OP_COPY_UNALIGNED,
+    OP_SET,
+    OP_MOVE,
+    OP_COMPARE,
+    OP_COUNT
+};
+
+static const char* op_names[OP_COUNT] = {"memcpy", "memcpy+1", "memset", "memmove", "memcmp"};
+static const char* path_names[] = {"bytes", "words", "sse2"};
+static const size_t sizes[] = {16, 64, 256, 1024, 4096, 65536, 1024 * 1024, 4 * 1024 * 1024};
+
+#define SIZE_COUNT (int)(sizeof(sizes) / sizeof(sizes[0]))
+
+static uint8_t* src_buffer;
+static uint8_t* dst_buffer;
+
+// Keeps memcmp results alive so the calls can't be dropped
+static volatile int sink;
+
+static uint64_t now_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+static void run_op(int op, size_t size)
+{
+    switch (op)
+    {
+    case OP_COPY:
+        memcpy(dst_buffer, src_buffer, size);
+        break;
+    case OP_COPY_UNALIGNED:
+        memcpy(dst_buffer, src_buffer + 1, size);
+        break;
+    case OP_SET:
+        memset(dst_buffer, 0x5A, size);
+        break;
+    case OP_MOVE:
+        memmove(src_buffer + 8, src_buffer, size);
+        break;
+    case OP_COMPARE:
+        sink += memcmp(src_buffer, dst_buffer, (int)size);
+        break;
+    }
+}
+
+/*
+ * measure - MB/s of op at size with the current memory path
+ *
+ * One untimed call first so the buffers are in the cache (or not, for the
+ * sizes that don't fit) the same way for every path.
+ */
+static uint32_t measure(int op, size_t size, uint64_t bytes_per_run)
+{
+    uint64_t rounds = bytes_per_run / size;
+    if (rounds == 0)
+    {
+        rounds = 1;
+    }
+
+    if (op == OP_COMPARE)
+    {
+        memcpy(dst_buffer, src_buffer, size);
+    }
+    run_op(op, size);
+
+    uint64_t start = now_ns();
+    for (uint64_t i = 0; i < rounds; i++)
+    {
+        run_op(op, size);
+    }
+    uint64_t elapsed = now_ns() - start;
+    if (elapsed == 0)
+    {
+        elapsed = 1;
+    }
+
+    // bytes/ns * 1000 = MB/s
+    return (uint32_t)((rounds * size * 1000ull) / elapsed);
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t mb_per_run = (argc > 1) ? (uint64_t)atoi(argv[1]) : DEFAULT_MB_PER_RUN;
+    if (mb_per_run == 0)
+    {
+        mb_per_run = 1;
+    }
+
+    // 64 byte aligned, so the aligned cases start on a cache line
+    src_buffer = (uint8_t*)(((uintptr_t)malloc(BUFFER_SIZE + 64) + 63) & ~(uintptr_t)63);
+    dst_buffer = (uint8_t*)(((uintptr_t)malloc(BUFFER_SIZE + 64) + 63) & ~(uintptr_t)63);
+    for (int i = 0; i < BUFFER_SIZE; i++)
+    {
+        src_buffer[i] = (uint8_t)(i * 7);
+    }
+
+    memory_init();
+    int best = memory_get_path();
+
+    printf("%llu MB per measurement, MB/s, default path %s\n",
+           (unsigned long long)mb_per_run, path_names[best]);
+
+    for (int op = 0; op < OP_COUNT; op++)
+    {
+        printf("\n%-10s", op_names[op]);
+        for (int path = MEMORY_PATH_BYTES; path <= best; path++)
+        {
+            printf(" %10s", path_names[path]);
+        }
+        printf("\n");
+
+        for (int i = 0; i < SIZE_COUNT; i++)
+        {
+            printf("%-10zu", sizes[i]);
+            for (int path = MEMORY_PATH_BYTES; path <= best; path++)
+            {
+                memory_set_path(path);
+                printf(" %10u", measure(op, sizes[i], mb_per_run * 1024 * 1024));
+            }
+            printf("\n");
+        }
+    }
+
+    memory_set_path(best);
+    return 0;
+}
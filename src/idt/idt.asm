@@ -27,6 +27,7 @@ idt_load:
 int21h:
     cli
     pushad
+    cld                  ; ADDED: C code expects DF clear (memmove sets it)
     call int21h_handler
     popad
     iret
@@ -34,6 +35,7 @@ int21h:
 no_interrupt:
     cli
     pushad
+    cld                  ; ADDED: C code expects DF clear (memmove sets it)
     call no_interrupt_handler
     mov al, 0x20
     out 0x20, al
@@ -47,12 +49,60 @@ global irq0_handler
 irq0_handler:
     cli
     pushad
+    cld                  ; ADDED: C code expects DF clear (memmove sets it)
     call timer_handler
     mov al, 0x20
     out 0x20, al
     popad
     iret
 
+; ADDED: COM1 interrupt handler (IRQ4 = interrupt 0x24)
+extern serial_handler
+
+global irq4_handler
+irq4_handler:
+    cli
+    pushad
+    cld                  ; ADDED: C code expects DF clear (memmove sets it)
+    call serial_handler
+    mov al, 0x20
+    out 0x20, al
+    popad
+    iret
+
+; ADDED: Primary ATA channel (IRQ14 = interrupt 0x2E, on the slave PIC)
+extern disk_queue_irq
+
+global irq14_handler
+irq14_handler:
+    cli
+    pushad
+    cld                  ; ADDED: C code expects DF clear (memmove sets it)
+    call disk_queue_irq
+    mov al, 0x20
+    out 0xA0, al
+    out 0x20, al
+    popad
+    iret
+
+; ADDED: Page fault (exception 14). The CPU pushes an error code, which
+; has to come off before iret; CR2 holds the address that faulted.
+extern idt_page_fault_handler
+
+global page_fault
+page_fault:
+    cli
+    pushad
+    cld                  ; ADDED: C code expects DF clear (memmove sets it)
+    push dword [esp+32]  ; error code, above the pushad frame
+    mov eax, cr2
+    push eax
+    call idt_page_fault_handler
+    add esp, 8
+    popad
+    add esp, 4           ; error code
+    iret
+
 global exception_halt
 exception_halt:
     cli
@@ -3,6 +3,8 @@
 #include "kernel.h"
 #include "memory/memory.h"
 #include "io/io.h"
+#include "fs/mmap.h"
+#include "memory/paging/paging.h"
 struct idt_desc idt_descriptors[PEACHOS_TOTAL_INTERRUPTS];
 struct idtr_desc idtr_descriptor;
 
@@ -10,6 +12,9 @@ extern void idt_load(struct idtr_desc* ptr);
 extern void int21h();
 extern void no_interrupt();
 extern void irq0_handler();  // ADDED: Timer handler from idt.asm
+extern void irq4_handler();  // ADDED: COM1 handler from idt.asm
+extern void irq14_handler();  // ADDED: Primary ATA channel from idt.asm
+extern void page_fault();  // ADDED: Exception 14 from idt.asm
 extern void keyboard_handler();  // ADDED: From keyboard.c
 extern void exception_halt();
 
@@ -28,6 +33,18 @@ void idt_zero()
     while(1) {}
 }
 
+// ADDED: From page_fault in idt.asm. A missing page in a file mapping is
+// read in and the faulting instruction runs again; anything else is fatal.
+void idt_page_fault_handler(uint32_t address, uint32_t error_code)
+{
+    if (!(error_code & PAGING_FAULT_PRESENT) && fmmap_fault((void*)address) == 0)
+    {
+        return;
+    }
+
+    panic("Page fault\n");
+}
+
 void idt_set(int interrupt_no, void* address)
 {
     struct idt_desc* desc = &idt_descriptors[interrupt_no];
@@ -51,6 +68,14 @@ void idt_init(void)
     disable_interrupts();
     
     outb(0x21, 0xFF);
+
+    // ADDED: The slave PIC still has the BIOS setup. Move it to 0x28-0x2F
+    // (ICW1-ICW4: cascade on IRQ2, 8086 mode), all lines masked; drivers
+    // unmask what they use.
+    outb(0xA0, 0x11);
+    outb(0xA1, 0x28);
+    outb(0xA1, 0x02);
+    outb(0xA1, 0x01);
     outb(0xA1, 0xFF);
     
     memset(idt_descriptors, 0, sizeof(idt_descriptors));
@@ -62,8 +87,11 @@ void idt_init(void)
         idt_set(i, no_interrupt);
     
     idt_set(0, idt_zero);
+    idt_set(14, page_fault);
     idt_set(0x20, irq0_handler);
     idt_set(0x21, int21h);
+    idt_set(0x24, irq4_handler);
+    idt_set(0x2E, irq14_handler);
     
     idt_load(&idtr_descriptor);
 }
\ No newline at end of file
@@ -7,4 +7,8 @@ unsigned short insw(unsigned short port);
 void outb(unsigned short port, unsigned char val);
 void outw(unsigned short port, unsigned short val);
 
+// ADDED: 32-bit port I/O (PCI configuration space)
+unsigned int insl(unsigned short port);
+void outl(unsigned short port, unsigned int val);
+
 #endif
\ No newline at end of file
@@ -16,6 +16,8 @@
 #include "timer/timer.h"  // ADDED: Timer functions
 #include "keyboard/keyboard.h"  // ADDED
 #include "graphics/vga.h" // ADDED
+#include "serial/serial.h"
+#include "telemetry/telemetry.h"
 #include "breakout/breakout.h"
 #include "breakout/breakout_menu.h"
 
@@ -71,6 +73,9 @@ void print(const char* str)
     {
         terminal_writechar(str[i], 15);
     }
+
+    // ADDED: The text buffer isn't visible in mode 13h - copy to COM1
+    serial_write(str, len);
 }
 
 
@@ -79,6 +84,7 @@ static struct paging_4gb_chunk* kernel_chunk = 0;
 void panic(const char* msg)
 {
     print(msg);
+    serial_flush();
     while(1) {}
 }
 
@@ -137,6 +143,7 @@ static void load_wad_to_ram(void)
     if (!wad_data)
     {
         vga_clear(4); // red = alloc fail
+        vga_present();
         while (1) {}
     }
 
@@ -144,6 +151,7 @@ static void load_wad_to_ram(void)
     if (!stream)
     {
         vga_clear(5); // magenta = streamer fail
+        vga_present();
         while (1) {}
     }
 
@@ -155,6 +163,7 @@ static void load_wad_to_ram(void)
     if (res < 0)
     {
         vga_clear(1); // blue = read fail
+        vga_present();
         while (1) {}
     }
 
@@ -162,11 +171,13 @@ static void load_wad_to_ram(void)
     if (!(p[0]=='I' && p[1]=='W' && p[2]=='A' && p[3]=='D'))
     {
         vga_clear(6); // brown = bad header
+        vga_present();
         while (1) {}
     }
 
     // Green = WAD OK
     vga_clear(2);
+    vga_present();
 }
 
 
@@ -175,6 +186,9 @@ void kernel_main()
     // DON'T initialize terminal - we're in graphics mode now!
     // terminal_initialize();  // REMOVE THIS
     
+    // ADDED: Pick the fastest mem* for this CPU (and turn on SSE for it)
+    memory_init();
+
     // Setup GDT (no visual output)
     memset(gdt_real, 0x00, sizeof(gdt_real));
     gdt_structured_to_gdt(gdt_real, gdt_structured, PEACHOS_TOTAL_GDT_SEGMENTS);
@@ -189,6 +203,13 @@ void kernel_main()
     // Initialize IDT
     idt_init();
     
+    // ADDED: COM1 telemetry (drained by IRQ4 once interrupts are on)
+    telemetry_init();
+
+    // ADDED: Disk 0, its sector cache and request queue (needs the heap,
+    // and the PICs as idt_init() leaves them)
+    disk_search_and_init();
+    
     // Setup paging
     kernel_chunk = paging_new_4gb(PAGING_IS_WRITEABLE | PAGING_IS_PRESENT | PAGING_ACCESS_FROM_ALL);
     paging_switch(paging_4gb_chunk_get_directory(kernel_chunk));
@@ -206,10 +227,18 @@ void kernel_main()
     // ADDED: Initialize VGA (already in mode 13h from boot)
     vga_init();
 
+#ifdef PEACHOS_BENCHMARK
+    // ADDED: Benchmark build - no menu, a scripted one-player game that
+    // ends by powering QEMU off (see breakout/breakout_benchmark.c)
+    benchmark_start();
+    int num_players = 1;
+#else
     int num_players = menu_run();
+#endif
 
     if (num_players == 0){
         vga_clear(0);
+        vga_present();
 
         while(1) {}
     }
@@ -223,6 +252,7 @@ void kernel_main()
     // ------------------------------------------------------------------------
     // User pressed ESC, game loop exited
     vga_clear(0);
+    vga_present();
     
     while(1) {}
     
@@ -62,6 +62,30 @@ void keyboard_init()
     buffer_write_pos = 0;
 }
 
+void keyboard_inject(uint8_t scancode, bool pressed)
+{
+    // ADDED: Same path as the IRQ1 handler, so keep it from running while
+    // the write position moves (the host build has no interrupts to stop)
+#ifndef PEACHOS_HOST
+    uint32_t flags;
+    __asm__ volatile("pushfl; popl %0; cli" : "=r"(flags) : : "memory");
+#endif
+    
+    int next_write = (buffer_write_pos + 1) % KEYBOARD_BUFFER_SIZE;
+    if (next_write != buffer_read_pos)
+    {
+        keyboard_buffer[buffer_write_pos].scancode = scancode;
+        keyboard_buffer[buffer_write_pos].ascii =
+            (scancode < sizeof(scancode_to_ascii)) ? scancode_to_ascii[scancode] : 0;
+        keyboard_buffer[buffer_write_pos].pressed = pressed;
+        buffer_write_pos = next_write;
+    }
+    
+#ifndef PEACHOS_HOST
+    __asm__ volatile("pushl %0; popfl" : : "r"(flags) : "memory", "cc");
+#endif
+}
+
 bool keyboard_get_event(key_event_t* event)
 {
     // ADDED: Check if buffer has events
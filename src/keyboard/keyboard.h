@@ -20,6 +20,10 @@ typedef struct {
 // ADDED: Initialize keyboard (clears buffer)
 void keyboard_init();
 
+// ADDED: Queue a key event as if it had been typed (scripted input for
+// the benchmark build). Dropped if the buffer is full.
+void keyboard_inject(uint8_t scancode, bool pressed);
+
 // ADDED: Get next key event (returns false if no event available)
 bool keyboard_get_event(key_event_t* event);
 
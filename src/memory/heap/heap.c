@@ -25,33 +25,6 @@ static bool heap_validate_alignment(void* ptr)
     return ((unsigned int)ptr % PEACHOS_HEAP_BLOCK_SIZE) == 0;
 }
 
-int heap_create(struct heap* heap, void* ptr, void* end, struct heap_table* table)
-{
-    int res = 0;
-
-    if (!heap_validate_alignment(ptr) || !heap_validate_alignment(end))
-    {
-        res = -EINVARG;
-        goto out;
-    }
-
-    memset(heap, 0, sizeof(struct heap));
-    heap->saddr = ptr;
-    heap->table = table;
-
-    res = heap_validate_table(ptr, end, table);
-    if (res < 0)
-    {
-        goto out;
-    }
-
-    size_t table_size = sizeof(HEAP_BLOCK_TABLE_ENTRY) * table->total;
-    memset(table->entries, HEAP_BLOCK_TABLE_ENTRY_FREE, table_size);
-
-out:
-    return res;
-}
-
 static uint32_t heap_align_value_to_upper(uint32_t val)
 {
     if ((val % PEACHOS_HEAP_BLOCK_SIZE) == 0)
@@ -69,57 +42,193 @@ static int heap_get_entry_type(HEAP_BLOCK_TABLE_ENTRY entry)
     return entry & 0x0f;
 }
 
-int heap_get_start_block(struct heap* heap, uint32_t total_blocks)
+static bool heap_block_is_free(struct heap* heap, int block)
 {
-    struct heap_table* table = heap->table;
-    int bc = 0;
-    int bs = -1;
+    return heap_get_entry_type(heap->table->entries[block]) == HEAP_BLOCK_TABLE_ENTRY_FREE;
+}
 
-    for (size_t i = 0; i < table->total; i++)
-    {
-        if (heap_get_entry_type(table->entries[i]) != HEAP_BLOCK_TABLE_ENTRY_FREE)
-        {
-            bc = 0;
-            bs = -1;
-            continue;
-        }
+// Size class of a run: index of its highest set bit (bsr), capped
+static int heap_free_list_index(uint32_t blocks)
+{
+    uint32_t index;
+    __asm__("bsrl %1, %0" : "=r"(index) : "rm"(blocks) : "cc");
+    return index < HEAP_FREE_LISTS ? (int)index : HEAP_FREE_LISTS - 1;
+}
 
-        if (bs == -1)
-            bs = (int)i;
+// Lowest size class at or above first that has a run (bsf), or -1
+static int heap_free_list_find(struct heap* heap, int first)
+{
+    if (first >= HEAP_FREE_LISTS)
+        return -1;
 
-        bc++;
+    uint32_t map = heap->free_list_map & (0xFFFFFFFF << first);
+    if (!map)
+        return -1;
 
-        if (bc == (int)total_blocks)
-            return bs;
-    }
+    uint32_t index;
+    __asm__("bsfl %1, %0" : "=r"(index) : "rm"(map) : "cc");
+    return (int)index;
+}
 
-    return -ENOMEM;
+static void heap_free_run_insert(struct heap* heap, int start, uint32_t blocks)
+{
+    int list = heap_free_list_index(blocks);
+    struct heap_free_run* run = &heap->runs[start];
+
+    run->blocks = blocks;
+    run->prev = -1;
+    run->next = heap->free_lists[list];
+    if (run->next != -1)
+        heap->runs[run->next].prev = start;
+
+    heap->free_lists[list] = start;
+    heap->free_list_map |= (1 << list);
+
+    // Boundary tag for the neighbour on the right
+    heap->runs[start + blocks - 1].blocks = blocks;
 }
 
+static void heap_free_run_remove(struct heap* heap, int start)
+{
+    struct heap_free_run* run = &heap->runs[start];
+    int list = heap_free_list_index(run->blocks);
+
+    if (run->prev != -1)
+        heap->runs[run->prev].next = run->next;
+    else
+        heap->free_lists[list] = run->next;
+
+    if (run->next != -1)
+        heap->runs[run->next].prev = run->prev;
+
+    if (heap->free_lists[list] == -1)
+        heap->free_list_map &= ~(1 << list);
+}
 
 void* heap_block_to_address(struct heap* heap, int block)
 {
     return (void*)((uint32_t)heap->saddr + (block * PEACHOS_HEAP_BLOCK_SIZE));
 }
 
+int heap_address_to_block(struct heap* heap, void* address)
+{
+    return ((int)(address - heap->saddr)) / PEACHOS_HEAP_BLOCK_SIZE;
+}
+
 void heap_mark_blocks_taken(struct heap* heap, int start_block, int total_blocks)
 {
     int end_block = (start_block + total_blocks) - 1;
 
-    HEAP_BLOCK_TABLE_ENTRY entry = HEAP_BLOCK_TABLE_ENTRY_TAKEN | HEAP_BLOCK_IS_FIRST;
-    if (total_blocks > 1)
-        entry |= HEAP_BLOCK_HAS_NEXT;
-
+    // Every block but the last has HAS_NEXT, or freeing would run on into
+    // the allocation after this one
     for (int i = start_block; i <= end_block; i++)
     {
-        heap->table->entries[i] = entry;
-
-        entry = HEAP_BLOCK_TABLE_ENTRY_TAKEN;
+        HEAP_BLOCK_TABLE_ENTRY entry = HEAP_BLOCK_TABLE_ENTRY_TAKEN;
+        if (i == start_block)
+            entry |= HEAP_BLOCK_IS_FIRST;
         if (i != end_block)
             entry |= HEAP_BLOCK_HAS_NEXT;
+
+        heap->table->entries[i] = entry;
     }
 }
 
+// Returns the number of blocks freed
+int heap_mark_blocks_free(struct heap* heap, int starting_block)
+{
+    struct heap_table* table = heap->table;
+    int count = 0;
+    for (int i = starting_block; i < (int)table->total; i++)
+    {
+        HEAP_BLOCK_TABLE_ENTRY entry = table->entries[i];
+        table->entries[i] = HEAP_BLOCK_TABLE_ENTRY_FREE;
+        count++;
+        if (!(entry & HEAP_BLOCK_HAS_NEXT))
+        {
+            break;
+        }
+    }
+    return count;
+}
+
+int heap_create(struct heap* heap, void* ptr, void* end, struct heap_table* table)
+{
+    int res = 0;
+
+    if (!heap_validate_alignment(ptr) || !heap_validate_alignment(end))
+    {
+        res = -EINVARG;
+        goto out;
+    }
+
+    memset(heap, 0, sizeof(struct heap));
+    heap->saddr = ptr;
+    heap->table = table;
+
+    res = heap_validate_table(ptr, end, table);
+    if (res < 0)
+    {
+        goto out;
+    }
+
+    size_t table_size = sizeof(HEAP_BLOCK_TABLE_ENTRY) * table->total;
+    memset(table->entries, HEAP_BLOCK_TABLE_ENTRY_FREE, table_size);
+
+    for (int i = 0; i < HEAP_FREE_LISTS; i++)
+    {
+        heap->free_lists[i] = -1;
+    }
+
+    // The free run bookkeeping takes the first blocks of the pool
+    uint32_t runs_size = heap_align_value_to_upper(sizeof(struct heap_free_run) * table->total);
+    int runs_blocks = runs_size / PEACHOS_HEAP_BLOCK_SIZE;
+    if (runs_blocks >= (int)table->total)
+    {
+        res = -ENOMEM;
+        goto out;
+    }
+
+    heap->runs = (struct heap_free_run*)ptr;
+    memset(heap->runs, 0, runs_size);
+    heap_mark_blocks_taken(heap, 0, runs_blocks);
+
+    heap->free_blocks = table->total - runs_blocks;
+    heap_free_run_insert(heap, runs_blocks, heap->free_blocks);
+
+out:
+    return res;
+}
+
+// First block of a free run of at least total_blocks, or -ENOMEM
+int heap_get_start_block(struct heap* heap, uint32_t total_blocks)
+{
+    // Runs in the request's own class may be too small; look at a few.
+    // Any run in a bigger class fits, so the first one there will do.
+    int list = heap_free_list_index(total_blocks);
+    int block = heap->free_lists[list];
+    for (int i = 0; i < HEAP_FREE_LIST_SEARCH && block != -1; i++)
+    {
+        if (heap->runs[block].blocks >= total_blocks)
+            return block;
+
+        block = heap->runs[block].next;
+    }
+
+    list = heap_free_list_find(heap, list + 1);
+    if (list >= 0)
+        return heap->free_lists[list];
+
+    // Nothing bigger: go through the rest of the request's own class
+    while (block != -1)
+    {
+        if (heap->runs[block].blocks >= total_blocks)
+            return block;
+
+        block = heap->runs[block].next;
+    }
+
+    return -ENOMEM;
+}
 
 void* heap_malloc_blocks(struct heap* heap, uint32_t total_blocks)
 {
@@ -131,42 +240,115 @@ void* heap_malloc_blocks(struct heap* heap, uint32_t total_blocks)
         goto out;
     }
 
+    // Take the front of the run; whatever is left stays free
+    uint32_t run_blocks = heap->runs[start_block].blocks;
+    heap_free_run_remove(heap, start_block);
+    if (run_blocks > total_blocks)
+    {
+        heap_free_run_insert(heap, start_block + total_blocks, run_blocks - total_blocks);
+    }
+
     address = heap_block_to_address(heap, start_block);
 
     // Mark the blocks as taken
     heap_mark_blocks_taken(heap, start_block, total_blocks);
+    heap->free_blocks -= total_blocks;
 
 out:
     return address;
 }
 
-void heap_mark_blocks_free(struct heap* heap, int starting_block)
+void* heap_malloc(struct heap* heap, size_t size)
 {
-    struct heap_table* table = heap->table;
-    for (int i = starting_block; i < (int)table->total; i++)
+    if (size == 0)
+        return 0;
+
+    size_t aligned_size = heap_align_value_to_upper(size);
+    uint32_t total_blocks = aligned_size / PEACHOS_HEAP_BLOCK_SIZE;
+    return heap_malloc_blocks(heap, total_blocks);
+}
+
+void heap_free(struct heap* heap, void* ptr)
+{
+    // Only the start of an allocation can be freed; anything else would
+    // corrupt the free lists
+    int start = heap_address_to_block(heap, ptr);
+    if (ptr < heap->saddr || start >= (int)heap->table->total ||
+        (heap->table->entries[start] & (HEAP_BLOCK_IS_FIRST | 0x0f)) !=
+            (HEAP_BLOCK_IS_FIRST | HEAP_BLOCK_TABLE_ENTRY_TAKEN))
     {
-        HEAP_BLOCK_TABLE_ENTRY entry = table->entries[i];
-        table->entries[i] = HEAP_BLOCK_TABLE_ENTRY_FREE;
-        if (!(entry & HEAP_BLOCK_HAS_NEXT))
-        {
-            break;
-        }
+        return;
     }
+
+    uint32_t blocks = heap_mark_blocks_free(heap, start);
+    heap->free_blocks += blocks;
+
+    // Merge with the free runs on either side
+    int after = start + blocks;
+    if (after < (int)heap->table->total && heap_block_is_free(heap, after))
+    {
+        blocks += heap->runs[after].blocks;
+        heap_free_run_remove(heap, after);
+    }
+
+    if (start > 0 && heap_block_is_free(heap, start - 1))
+    {
+        int before = start - heap->runs[start - 1].blocks;
+        blocks += heap->runs[before].blocks;
+        heap_free_run_remove(heap, before);
+        start = before;
+    }
+
+    heap_free_run_insert(heap, start, blocks);
 }
 
-int heap_address_to_block(struct heap* heap, void* address)
+uint32_t heap_allocation_blocks(struct heap* heap, void* ptr)
 {
-    return ((int)(address - heap->saddr)) / PEACHOS_HEAP_BLOCK_SIZE;
+    int start = heap_address_to_block(heap, ptr);
+    if (ptr < heap->saddr || start >= (int)heap->table->total ||
+        !(heap->table->entries[start] & HEAP_BLOCK_IS_FIRST))
+    {
+        return 0;
+    }
+
+    uint32_t count = 1;
+    for (int i = start; i < (int)heap->table->total - 1; i++)
+    {
+        if (!(heap->table->entries[i] & HEAP_BLOCK_HAS_NEXT))
+            break;
+        count++;
+    }
+    return count;
 }
 
-void* heap_malloc(struct heap* heap, size_t size)
+uint32_t heap_free_run_count(struct heap* heap)
 {
-    size_t aligned_size = heap_align_value_to_upper(size);
-    uint32_t total_blocks = aligned_size / PEACHOS_HEAP_BLOCK_SIZE;
-    return heap_malloc_blocks(heap, total_blocks);
+    uint32_t count = 0;
+    for (int list = 0; list < HEAP_FREE_LISTS; list++)
+    {
+        for (int block = heap->free_lists[list]; block != -1; block = heap->runs[block].next)
+        {
+            count++;
+        }
+    }
+    return count;
 }
 
-void heap_free(struct heap* heap, void* ptr)
+uint32_t heap_largest_free_run(struct heap* heap)
 {
-    heap_mark_blocks_free(heap, heap_address_to_block(heap, ptr));
-}
\ No newline at end of file
+    // Only the highest non-empty class can hold the largest run
+    for (int list = HEAP_FREE_LISTS - 1; list >= 0; list--)
+    {
+        if (heap->free_lists[list] == -1)
+            continue;
+
+        uint32_t largest = 0;
+        for (int block = heap->free_lists[list]; block != -1; block = heap->runs[block].next)
+        {
+            if (heap->runs[block].blocks > largest)
+                largest = heap->runs[block].blocks;
+        }
+        return largest;
+    }
+    return 0;
+}
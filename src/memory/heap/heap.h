@@ -11,6 +11,14 @@
 #define HEAP_BLOCK_IS_FIRST  0b01000000
 
 
+// Free runs are kept in size classes: list i holds runs of 2^i up to
+// 2^(i+1) - 1 blocks (the last list holds everything bigger)
+#define HEAP_FREE_LISTS 16
+
+// How many too-small runs malloc looks at in the request's own size class
+// before taking a run from a bigger class
+#define HEAP_FREE_LIST_SEARCH 8
+
 typedef unsigned char HEAP_BLOCK_TABLE_ENTRY;
 
 struct heap_table
@@ -19,6 +27,15 @@ struct heap_table
     size_t total;
 };
 
+// Bookkeeping for one free run, stored under the run's first block (size
+// and links) and under its last block (size, so a block being freed can
+// find the start of the free run before it)
+struct heap_free_run
+{
+    uint32_t blocks;
+    int32_t next;
+    int32_t prev;
+};
 
 struct heap
 {
@@ -26,9 +43,28 @@ struct heap
 
     // Start address of the heap data pool
     void* saddr;
+
+    // One entry per block, valid at both ends of each free run. Lives in
+    // the first blocks of the pool, which stay marked taken.
+    struct heap_free_run* runs;
+
+    // First block of the first run in each size class, or -1
+    int32_t free_lists[HEAP_FREE_LISTS];
+
+    // Bit i set when free_lists[i] isn't empty
+    uint32_t free_list_map;
+
+    uint32_t free_blocks;
 };
 
 int heap_create(struct heap* heap, void* ptr, void* end, struct heap_table* table);
 void* heap_malloc(struct heap* heap, size_t size);
 void heap_free(struct heap* heap, void* ptr);
+
+// Blocks held by the allocation starting at ptr (0 if it isn't one)
+uint32_t heap_allocation_blocks(struct heap* heap, void* ptr);
+
+// Free space layout: number of free runs and the longest one, in blocks
+uint32_t heap_free_run_count(struct heap* heap);
+uint32_t heap_largest_free_run(struct heap* heap);
 #endif
\ No newline at end of file
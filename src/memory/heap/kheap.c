@@ -1,12 +1,33 @@
 #include "kheap.h"
 #include "heap.h"
+#include "slab.h"
 #include "config.h"
 #include "kernel.h"
 #include "memory/memory.h"
+#include "telemetry/telemetry.h"
 
 struct heap kernel_heap;
 struct heap_table kernel_heap_table;
 
+static TELEMETRY_COUNTER(kheap_allocs, "heap.allocs");
+static TELEMETRY_COUNTER(kheap_alloc_bytes, "heap.alloc_bytes");
+static TELEMETRY_COUNTER(kheap_alloc_fails, "heap.alloc_fails");
+static TELEMETRY_COUNTER(kheap_frees, "heap.frees");
+
+static uint32_t kheap_live_bytes = 0;
+static uint32_t kheap_peak_bytes = 0;
+static uint32_t kheap_live_allocs = 0;
+static uint32_t kheap_class_allocs[KHEAP_SIZE_CLASSES];
+
+#ifdef PEACHOS_HEAP_DEBUG
+static struct kheap_allocation kheap_tracked[KHEAP_TRACK_MAX];
+static uint32_t kheap_untracked = 0;
+#endif
+
+// Block map published by kheap_publish(): one character per cell
+#define KHEAP_MAP_COLUMNS 64
+#define KHEAP_MAP_ROWS 4
+
 void kheap_init()
 {
     int total_table_entries = PEACHOS_HEAP_SIZE_BYTES / PEACHOS_HEAP_BLOCK_SIZE;
@@ -20,16 +41,77 @@ void kheap_init()
         print("Failed to create heap\n");
     }
 
+    // Small objects share blocks through the slab caches
+    slab_init(&kernel_heap);
+}
+
+static int kheap_size_class(size_t size)
+{
+    int index = 0;
+    while (index < KHEAP_SIZE_CLASSES - 1 && ((size_t)16 << index) < size)
+    {
+        index++;
+    }
+    return index;
+}
+
+// Bytes the allocator really holds for ptr
+static uint32_t kheap_held_bytes(void* ptr)
+{
+    if (slab_owns(ptr))
+        return slab_object_size(ptr);
+
+    return heap_allocation_blocks(&kernel_heap, ptr) * PEACHOS_HEAP_BLOCK_SIZE;
+}
+
+static void* kheap_alloc(size_t size, void* caller)
+{
+    void* ptr = (size <= SLAB_MAX_SIZE) ? slab_alloc(size) : heap_malloc(&kernel_heap, size);
+    if (!ptr)
+    {
+        telemetry_count(&kheap_alloc_fails, 1);
+        return 0;
+    }
+
+    telemetry_count(&kheap_allocs, 1);
+    telemetry_count(&kheap_alloc_bytes, size);
+    kheap_class_allocs[kheap_size_class(size)]++;
+
+    kheap_live_allocs++;
+    kheap_live_bytes += kheap_held_bytes(ptr);
+    if (kheap_live_bytes > kheap_peak_bytes)
+        kheap_peak_bytes = kheap_live_bytes;
+
+#ifdef PEACHOS_HEAP_DEBUG
+    int slot = 0;
+    while (slot < KHEAP_TRACK_MAX && kheap_tracked[slot].ptr)
+    {
+        slot++;
+    }
+
+    if (slot < KHEAP_TRACK_MAX)
+    {
+        kheap_tracked[slot].ptr = ptr;
+        kheap_tracked[slot].size = size;
+        kheap_tracked[slot].caller = caller;
+    }
+    else
+    {
+        kheap_untracked++;
+    }
+#endif
+
+    return ptr;
 }
 
 void* kmalloc(size_t size)
 {
-    return heap_malloc(&kernel_heap, size);
+    return kheap_alloc(size, __builtin_return_address(0));
 }
 
 void* kzalloc(size_t size)
 {
-    void* ptr = kmalloc(size);
+    void* ptr = kheap_alloc(size, __builtin_return_address(0));
     if (!ptr)
         return 0;
 
@@ -39,5 +121,199 @@ void* kzalloc(size_t size)
 
 void kfree(void* ptr)
 {
+    if (!ptr)
+        return;
+
+    telemetry_count(&kheap_frees, 1);
+
+    uint32_t held = kheap_held_bytes(ptr);
+    if (held)
+    {
+        kheap_live_bytes -= held;
+        kheap_live_allocs--;
+    }
+
+#ifdef PEACHOS_HEAP_DEBUG
+    for (int slot = 0; slot < KHEAP_TRACK_MAX; slot++)
+    {
+        if (kheap_tracked[slot].ptr == ptr)
+        {
+            kheap_tracked[slot].ptr = 0;
+            break;
+        }
+    }
+#endif
+
+    if (slab_owns(ptr))
+    {
+        slab_free(ptr);
+        return;
+    }
     heap_free(&kernel_heap, ptr);
-}
\ No newline at end of file
+}
+
+void kheap_get_stats(struct kheap_stats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+    stats->live_bytes = kheap_live_bytes;
+    stats->peak_bytes = kheap_peak_bytes;
+    stats->live_allocs = kheap_live_allocs;
+    stats->allocs = kheap_allocs.value;
+    stats->frees = kheap_frees.value;
+    stats->alloc_fails = kheap_alloc_fails.value;
+    for (int i = 0; i < KHEAP_SIZE_CLASSES; i++)
+    {
+        stats->class_allocs[i] = kheap_class_allocs[i];
+    }
+
+    stats->total_blocks = kernel_heap_table.total;
+    stats->free_blocks = kernel_heap.free_blocks;
+    stats->free_runs = heap_free_run_count(&kernel_heap);
+    stats->largest_free_run = heap_largest_free_run(&kernel_heap);
+    if (stats->free_blocks > 0)
+    {
+        stats->fragmentation = 100 - (stats->largest_free_run * 100) / stats->free_blocks;
+    }
+}
+
+int kheap_get_allocations(struct kheap_allocation* out, int max)
+{
+    int count = 0;
+#ifdef PEACHOS_HEAP_DEBUG
+    for (int slot = 0; slot < KHEAP_TRACK_MAX && count < max; slot++)
+    {
+        if (kheap_tracked[slot].ptr)
+        {
+            out[count++] = kheap_tracked[slot];
+        }
+    }
+#endif
+    return count;
+}
+
+static char* kheap_append(char* out, const char* text)
+{
+    while (*text)
+    {
+        *out++ = *text++;
+    }
+    *out = 0;
+    return out;
+}
+
+static char* kheap_append_hex(char* out, uint32_t value)
+{
+    out = kheap_append(out, "0x");
+    for (int shift = 28; shift >= 0; shift -= 4)
+    {
+        *out++ = "0123456789abcdef"[(value >> shift) & 0xF];
+    }
+    *out = 0;
+    return out;
+}
+
+static char* kheap_append_uint(char* out, uint32_t value)
+{
+    char digits[10];
+    int count = 0;
+    do
+    {
+        digits[count++] = '0' + (value % 10);
+        value /= 10;
+    } while (value);
+
+    while (count > 0)
+    {
+        *out++ = digits[--count];
+    }
+    *out = 0;
+    return out;
+}
+
+// One row of the block map: '.' cell all free, '#' all taken, '+' mixed
+static void kheap_format_map_row(char* line, int row)
+{
+    uint32_t total = kernel_heap_table.total;
+    uint32_t cells = KHEAP_MAP_COLUMNS * KHEAP_MAP_ROWS;
+    uint32_t per_cell = (total + cells - 1) / cells;
+
+    char* out = kheap_append(line, "heap map ");
+    *out++ = '0' + row;
+    *out++ = ' ';
+
+    for (int column = 0; column < KHEAP_MAP_COLUMNS; column++)
+    {
+        uint32_t first = (row * KHEAP_MAP_COLUMNS + column) * per_cell;
+        uint32_t taken = 0;
+        uint32_t blocks = 0;
+        for (uint32_t i = first; i < first + per_cell && i < total; i++)
+        {
+            if (kernel_heap_table.entries[i] & 0x0f)
+                taken++;
+            blocks++;
+        }
+
+        if (blocks == 0 || taken == 0)
+            *out++ = '.';
+        else if (taken == blocks)
+            *out++ = '#';
+        else
+            *out++ = '+';
+    }
+    *out = 0;
+}
+
+void kheap_publish()
+{
+    struct kheap_stats stats;
+    kheap_get_stats(&stats);
+
+    telemetry_value("heap.live_bytes", stats.live_bytes);
+    telemetry_value("heap.peak_bytes", stats.peak_bytes);
+    telemetry_value("heap.live_allocs", stats.live_allocs);
+    telemetry_value("heap.free_blocks", stats.free_blocks);
+    telemetry_value("heap.free_runs", stats.free_runs);
+    telemetry_value("heap.largest_free_run", stats.largest_free_run);
+    telemetry_value("heap.fragmentation", stats.fragmentation);
+
+    // Size classes that have been used: "heap class <up to bytes> <allocs>"
+    char line[KHEAP_MAP_COLUMNS + 16];
+    for (int i = 0; i < KHEAP_SIZE_CLASSES; i++)
+    {
+        if (!stats.class_allocs[i])
+            continue;
+
+        char* out = kheap_append(line, "heap class ");
+        out = (i == KHEAP_SIZE_CLASSES - 1) ? kheap_append(out, "big ") : kheap_append_uint(out, 16 << i);
+        out = kheap_append(out, " ");
+        kheap_append_uint(out, stats.class_allocs[i]);
+        telemetry_log(line);
+    }
+
+    for (int row = 0; row < KHEAP_MAP_ROWS; row++)
+    {
+        kheap_format_map_row(line, row);
+        telemetry_log(line);
+    }
+
+#ifdef PEACHOS_HEAP_DEBUG
+    // "heap live <address> <bytes> <caller>" - look callers up with
+    // nm/addr2line on build/kernelfull.o
+    for (int slot = 0; slot < KHEAP_TRACK_MAX; slot++)
+    {
+        struct kheap_allocation* a = &kheap_tracked[slot];
+        if (!a->ptr)
+            continue;
+
+        char* out = kheap_append(line, "heap live ");
+        out = kheap_append_hex(out, (uint32_t)a->ptr);
+        out = kheap_append(out, " ");
+        out = kheap_append_uint(out, a->size);
+        out = kheap_append(out, " ");
+        kheap_append_hex(out, (uint32_t)a->caller);
+        telemetry_log(line);
+    }
+    telemetry_value("heap.untracked", kheap_untracked);
+#endif
+}
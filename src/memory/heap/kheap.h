@@ -4,9 +4,59 @@
 #include <stdint.h>
 #include <stddef.h>
 
+// Allocation counts are kept per request size: class i counts requests of
+// up to 16 << i bytes, the last class everything bigger (over 512 KB)
+#define KHEAP_SIZE_CLASSES 17
+
+// Building with -DPEACHOS_HEAP_DEBUG (make all EXTRA_FLAGS=-DPEACHOS_HEAP_DEBUG)
+// also records who made each live allocation, for finding leaks. Up to
+// this many are tracked; more are counted but not listed.
+#define KHEAP_TRACK_MAX 512
+
+struct kheap_stats
+{
+    // Bytes held by live allocations (rounded up to the slab object or
+    // heap block size) and the most there have been at once
+    uint32_t live_bytes;
+    uint32_t peak_bytes;
+    uint32_t live_allocs;
+
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t alloc_fails;
+    uint32_t class_allocs[KHEAP_SIZE_CLASSES];
+
+    // Heap blocks (slab pages included) and how the free ones lie
+    uint32_t total_blocks;
+    uint32_t free_blocks;
+    uint32_t free_runs;
+    uint32_t largest_free_run;
+
+    // 0-100: share of the free blocks outside the largest free run. 0 means
+    // all free memory is one run; near 100 means it is scattered.
+    uint32_t fragmentation;
+};
+
+struct kheap_allocation
+{
+    void* ptr;
+    uint32_t size;      // As requested
+    void* caller;       // Return address of the kmalloc/kzalloc call
+};
+
 void kheap_init();
 void* kmalloc(size_t size);
 void* kzalloc(size_t size);
 void kfree(void* ptr);
 
-#endif
\ No newline at end of file
+void kheap_get_stats(struct kheap_stats* stats);
+
+// Live allocations recorded by PEACHOS_HEAP_DEBUG builds, oldest slot
+// first. Returns how many were written to out (0 without the debug build).
+int kheap_get_allocations(struct kheap_allocation* out, int max);
+
+// Statistics as telemetry values, then the block map and (debug builds)
+// the live allocations as LOG lines
+void kheap_publish();
+
+#endif
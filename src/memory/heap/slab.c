@@ -0,0 +1,184 @@
+#include "slab.h"
+#include "config.h"
+#include "memory/memory.h"
+
+static struct heap* slab_heap = 0;
+static struct slab_cache slab_caches[SLAB_CACHE_COUNT];
+
+static void slab_list_add(struct slab** list, struct slab* slab)
+{
+    slab->prev = 0;
+    slab->next = *list;
+    if (*list)
+        (*list)->prev = slab;
+    *list = slab;
+}
+
+static void slab_list_remove(struct slab** list, struct slab* slab)
+{
+    if (slab->prev)
+        slab->prev->next = slab->next;
+    else
+        *list = slab->next;
+
+    if (slab->next)
+        slab->next->prev = slab->prev;
+
+    slab->next = 0;
+    slab->prev = 0;
+}
+
+// Smallest cache that fits size (size must be 1..SLAB_MAX_SIZE)
+static int slab_cache_index(size_t size)
+{
+    int index = 0;
+    while ((1u << (SLAB_MIN_SHIFT + index)) < size)
+    {
+        index++;
+    }
+    return index;
+}
+
+void slab_init(struct heap* heap)
+{
+    slab_heap = heap;
+    memset(slab_caches, 0, sizeof(slab_caches));
+
+    for (int i = 0; i < SLAB_CACHE_COUNT; i++)
+    {
+        struct slab_cache* cache = &slab_caches[i];
+        cache->object_size = 1 << (SLAB_MIN_SHIFT + i);
+        cache->per_slab = (PEACHOS_HEAP_BLOCK_SIZE - SLAB_HEADER_SIZE) / cache->object_size;
+    }
+}
+
+static struct slab* slab_new(struct slab_cache* cache)
+{
+    struct slab* slab = heap_malloc(slab_heap, PEACHOS_HEAP_BLOCK_SIZE);
+    if (!slab)
+        return 0;
+
+    slab->magic = SLAB_MAGIC;
+    slab->cache = cache;
+    slab->next = 0;
+    slab->prev = 0;
+    slab->in_use = 0;
+    slab->capacity = cache->per_slab;
+
+    // Thread the free list through the objects, lowest address first
+    uint8_t* objects = (uint8_t*)slab + SLAB_HEADER_SIZE;
+    slab->free = 0;
+    for (int i = cache->per_slab - 1; i >= 0; i--)
+    {
+        void** object = (void**)(objects + i * cache->object_size);
+        *object = slab->free;
+        slab->free = object;
+    }
+
+    cache->slabs++;
+    return slab;
+}
+
+void* slab_alloc(size_t size)
+{
+    if (!slab_heap || size == 0 || size > SLAB_MAX_SIZE)
+        return 0;
+
+    struct slab_cache* cache = &slab_caches[slab_cache_index(size)];
+    struct slab* slab = cache->partial;
+    if (!slab)
+    {
+        slab = cache->empty;
+        cache->empty = 0;
+        if (!slab)
+        {
+            slab = slab_new(cache);
+            if (!slab)
+                return 0;
+        }
+        slab_list_add(&cache->partial, slab);
+    }
+
+    void** object = slab->free;
+    slab->free = *object;
+    slab->in_use++;
+    if (!slab->free)
+    {
+        slab_list_remove(&cache->partial, slab);
+        slab_list_add(&cache->full, slab);
+    }
+
+    cache->objects_in_use++;
+    cache->allocs++;
+    return object;
+}
+
+bool slab_owns(void* ptr)
+{
+    return ptr && ((uint32_t)ptr % PEACHOS_HEAP_BLOCK_SIZE) != 0;
+}
+
+static struct slab* slab_of(void* ptr)
+{
+    struct slab* slab = (struct slab*)((uint32_t)ptr & ~(PEACHOS_HEAP_BLOCK_SIZE - 1));
+    return (slab->magic == SLAB_MAGIC) ? slab : 0;
+}
+
+uint32_t slab_object_size(void* ptr)
+{
+    struct slab* slab = slab_of(ptr);
+    return slab ? slab->cache->object_size : 0;
+}
+
+void slab_free(void* ptr)
+{
+    struct slab* slab = slab_of(ptr);
+    if (!slab)
+        return;
+
+    struct slab_cache* cache = slab->cache;
+    bool was_full = (slab->free == 0);
+
+    *(void**)ptr = slab->free;
+    slab->free = ptr;
+    slab->in_use--;
+    cache->objects_in_use--;
+    cache->frees++;
+
+    if (was_full)
+    {
+        slab_list_remove(&cache->full, slab);
+        slab_list_add(&cache->partial, slab);
+    }
+
+    if (slab->in_use == 0)
+    {
+        // Keep one empty slab so an alloc/free pair at a slab boundary
+        // doesn't go to the heap every time
+        slab_list_remove(&cache->partial, slab);
+        if (!cache->empty)
+        {
+            cache->empty = slab;
+            return;
+        }
+
+        slab->magic = 0;
+        cache->slabs--;
+        heap_free(slab_heap, slab);
+    }
+}
+
+void slab_get_stats(int cache, struct slab_stats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (cache < 0 || cache >= SLAB_CACHE_COUNT)
+        return;
+
+    struct slab_cache* c = &slab_caches[cache];
+    stats->object_size = c->object_size;
+    stats->slabs = c->slabs;
+    stats->objects_in_use = c->objects_in_use;
+    stats->capacity = c->slabs * c->per_slab;
+    stats->allocs = c->allocs;
+    stats->frees = c->frees;
+}
@@ -0,0 +1,79 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include "heap.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Object sizes with their own cache: 16, 32, ... SLAB_MAX_SIZE bytes.
+// Bigger requests go to the heap as whole blocks.
+#define SLAB_MIN_SHIFT 4
+#define SLAB_CACHE_COUNT 7
+#define SLAB_MAX_SIZE (1 << (SLAB_MIN_SHIFT + SLAB_CACHE_COUNT - 1))
+
+// Each slab is one heap block; this much of it is the slab header
+#define SLAB_HEADER_SIZE 32
+
+#define SLAB_MAGIC 0x51AB51AB
+
+struct slab_cache;
+
+// Start of every slab page. Objects follow it, so no object is ever
+// block aligned - that is how kfree() tells them from heap allocations.
+struct slab
+{
+    uint32_t magic;
+    struct slab_cache* cache;
+    struct slab* next;
+    struct slab* prev;
+    void* free;         // First free object; each free object points to the next
+    uint16_t in_use;
+    uint16_t capacity;
+};
+
+struct slab_cache
+{
+    uint32_t object_size;
+    uint16_t per_slab;
+
+    // Slabs with at least one free object, and slabs with none
+    struct slab* partial;
+    struct slab* full;
+
+    // A slab whose objects are all free is kept here (at most one) rather
+    // than handed straight back to the heap
+    struct slab* empty;
+
+    uint32_t slabs;
+    uint32_t objects_in_use;
+    uint32_t allocs;
+    uint32_t frees;
+};
+
+struct slab_stats
+{
+    uint32_t object_size;
+    uint32_t slabs;
+    uint32_t objects_in_use;
+    uint32_t capacity;
+    uint32_t allocs;
+    uint32_t frees;
+};
+
+// Slab pages come from this heap
+void slab_init(struct heap* heap);
+
+// NULL if size is 0, bigger than SLAB_MAX_SIZE or memory ran out
+void* slab_alloc(size_t size);
+
+// True if ptr came from slab_alloc() (it isn't block aligned)
+bool slab_owns(void* ptr);
+void slab_free(void* ptr);
+
+// Size of the cache object ptr lives in (0 if it isn't a slab object)
+uint32_t slab_object_size(void* ptr);
+
+void slab_get_stats(int cache, struct slab_stats* stats);
+
+#endif
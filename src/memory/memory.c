@@ -1,38 +1,265 @@
 #include "memory.h"
+#include <stdint.h>
+
+// ADDED: Below this the wide paths cost more in setup than they save
+#define MEMORY_SMALL 16
+// ADDED: SSE2 is only worth it once there are a few 64 byte blocks to move
+#define MEMORY_SSE2_MIN 256
+// ADDED: std/cld cost more than a short backward byte loop
+#define MEMORY_BACKWARD_MIN 64
+
+#define MEMORY_CR0_MP (1 << 1)
+#define MEMORY_CR0_EM (1 << 2)
+#define MEMORY_CR4_OSFXSR (1 << 9)
+#define MEMORY_CR4_OSXMMEXCPT (1 << 10)
+
+// ADDED: Word path until memory_init() has looked at the CPU
+static int memory_path = MEMORY_PATH_WORDS;
+static bool memory_has_sse2 = false;
+// ADDED: Fast rep movs/stos microcode; with it rep beats SSE2 whenever
+// source and destination can both be word aligned
+static bool memory_has_erms = false;
+
+static bool memory_cpu_has_sse2()
+{
+    // ADDED: CPUID leaf 1, EDX bit 26
+    uint32_t eax = 1, ebx, ecx, edx;
+    __asm__ volatile("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx & (1 << 26)) != 0;
+}
+
+static bool memory_cpu_has_erms()
+{
+    // ADDED: CPUID leaf 7, EBX bit 9 (if leaf 7 exists at all)
+    uint32_t eax = 0, ebx, ecx = 0, edx;
+    __asm__ volatile("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+    if (eax < 7)
+        return false;
+
+    eax = 7;
+    ecx = 0;
+    __asm__ volatile("cpuid" : "+a"(eax), "=b"(ebx), "+c"(ecx), "=d"(edx));
+    return (ebx & (1 << 9)) != 0;
+}
+
+// ADDED: XMM registers are off until the OS says it handles them
+// (CR4.OSFXSR) and the FPU isn't emulated (CR0.EM). The interrupt
+// handlers don't save XMM state, so they must not use the SSE2 path.
+static void memory_enable_sse()
+{
+#ifndef PEACHOS_HOST
+    uint32_t cr0, cr4;
+    __asm__ volatile("mov %%cr0, %0" : "=r"(cr0));
+    cr0 = (cr0 & ~MEMORY_CR0_EM) | MEMORY_CR0_MP;
+    __asm__ volatile("mov %0, %%cr0" : : "r"(cr0));
+
+    __asm__ volatile("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= MEMORY_CR4_OSFXSR | MEMORY_CR4_OSXMMEXCPT;
+    __asm__ volatile("mov %0, %%cr4" : : "r"(cr4));
+#endif
+}
+
+void memory_init()
+{
+    memory_has_sse2 = memory_cpu_has_sse2();
+    memory_has_erms = memory_cpu_has_erms();
+    if (memory_has_sse2)
+    {
+        memory_enable_sse();
+    }
+    memory_path = memory_has_sse2 ? MEMORY_PATH_SSE2 : MEMORY_PATH_WORDS;
+}
+
+int memory_get_path()
+{
+    return memory_path;
+}
+
+bool memory_set_path(int path)
+{
+    if (path < MEMORY_PATH_BYTES || path > MEMORY_PATH_SSE2)
+        return false;
+
+    if (path == MEMORY_PATH_SSE2 && !memory_has_sse2)
+        return false;
+
+    memory_path = path;
+    return true;
+}
+
+// ADDED: 64 bytes per round into 16 byte aligned dst
+__attribute__((target("sse2")))
+static void memory_set_sse2(uint8_t* dst, uint32_t pattern, size_t blocks)
+{
+    __asm__ volatile(
+        "movd %2, %%xmm0\n\t"
+        "pshufd $0, %%xmm0, %%xmm0\n\t"
+        "1:\n\t"
+        "movdqa %%xmm0, (%0)\n\t"
+        "movdqa %%xmm0, 16(%0)\n\t"
+        "movdqa %%xmm0, 32(%0)\n\t"
+        "movdqa %%xmm0, 48(%0)\n\t"
+        "add $64, %0\n\t"
+        "dec %1\n\t"
+        "jnz 1b"
+        : "+r"(dst), "+r"(blocks)
+        : "r"(pattern)
+        : "xmm0", "memory", "cc");
+}
+
+// ADDED: 64 bytes per round, dst 16 byte aligned, src anywhere. All four
+// loads come before the stores, so this is safe for memmove when dst < src.
+__attribute__((target("sse2")))
+static void memory_copy_sse2(uint8_t* dst, const uint8_t* src, size_t blocks)
+{
+    __asm__ volatile(
+        "1:\n\t"
+        "movdqu (%1), %%xmm0\n\t"
+        "movdqu 16(%1), %%xmm1\n\t"
+        "movdqu 32(%1), %%xmm2\n\t"
+        "movdqu 48(%1), %%xmm3\n\t"
+        "movdqa %%xmm0, (%0)\n\t"
+        "movdqa %%xmm1, 16(%0)\n\t"
+        "movdqa %%xmm2, 32(%0)\n\t"
+        "movdqa %%xmm3, 48(%0)\n\t"
+        "add $64, %1\n\t"
+        "add $64, %0\n\t"
+        "dec %2\n\t"
+        "jnz 1b"
+        : "+r"(dst), "+r"(src), "+r"(blocks)
+        :
+        : "xmm0", "xmm1", "xmm2", "xmm3", "memory", "cc");
+}
 
 void* memset(void* ptr, int c, size_t size)
 {
-    char* c_ptr = (char*) ptr;
-    for (size_t i = 0; i < size; i++)  // FIXED: Use size_t instead of int
+    uint8_t* d = (uint8_t*)ptr;
+    uint8_t byte = (uint8_t)c;
+
+    if (memory_path == MEMORY_PATH_BYTES || size < MEMORY_SMALL)
+    {
+        for (size_t i = 0; i < size; i++)  // FIXED: Use size_t instead of int
+        {
+            d[i] = byte;
+        }
+        return ptr;
+    }
+
+    uint32_t pattern = byte * 0x01010101u;
+
+    // ADDED: Bytes up to a word boundary, then whole words, then the rest
+    while ((uintptr_t)d & 3)
+    {
+        *d++ = byte;
+        size--;
+    }
+
+    if (memory_path == MEMORY_PATH_SSE2 && !memory_has_erms && size >= MEMORY_SSE2_MIN)
+    {
+        while ((uintptr_t)d & 15)
+        {
+            *(uint32_t*)d = pattern;
+            d += 4;
+            size -= 4;
+        }
+
+        size_t blocks = size / 64;
+        memory_set_sse2(d, pattern, blocks);
+        d += blocks * 64;
+        size -= blocks * 64;
+    }
+
+    size_t words = size / 4;
+    __asm__ volatile("rep stosl" : "+D"(d), "+c"(words) : "a"(pattern) : "memory");
+
+    size &= 3;
+    while (size--)
     {
-        c_ptr[i] = (char) c;
+        *d++ = byte;
     }
     return ptr;
 }
 
 int memcmp(void* s1, void* s2, int count)
 {
-    char* c1 = s1;
-    char* c2 = s2;
-    while(count-- > 0)
+    const uint8_t* c1 = s1;
+    const uint8_t* c2 = s2;
+
+    // ADDED: Skip equal words; the bytes decide once a word differs
+    if (memory_path != MEMORY_PATH_BYTES)
+    {
+        while (count >= 4 && *(const uint32_t*)c1 == *(const uint32_t*)c2)
+        {
+            c1 += 4;
+            c2 += 4;
+            count -= 4;
+        }
+    }
+
+    while (count-- > 0)
     {
-        if (*c1++ != *c2++)
+        if (*c1 != *c2)
         {
-            return c1[-1] < c2[-1] ? -1 : 1;
+            return *c1 < *c2 ? -1 : 1;  // FIXED: Bytes compare as unsigned
         }
+        c1++;
+        c2++;
     }
 
     return 0;
 }
 
-void* memcpy(void* dest, const void* src, size_t len)  // FIXED
+// ADDED: Ascending copy. Also what memmove uses when dest is below src.
+static void memory_copy_forward(uint8_t* d, const uint8_t* s, size_t len)
 {
-    char* d = (char*)dest;
-    const char* s = (const char*)src;
-    for (size_t i = 0; i < len; i++)  // FIXED: size_t
+    if (memory_path == MEMORY_PATH_BYTES || len < MEMORY_SMALL)
+    {
+        for (size_t i = 0; i < len; i++)  // FIXED: size_t
+        {
+            d[i] = s[i];
+        }
+        return;
+    }
+
+    // ADDED: Align the destination; unaligned loads are the cheaper side
+    while ((uintptr_t)d & 3)
+    {
+        *d++ = *s++;
+        len--;
+    }
+
+    // ADDED: rep movsl with a misaligned source is slow everywhere
+    bool misaligned = ((uintptr_t)s & 3) != 0;
+    if (memory_path == MEMORY_PATH_SSE2 && (misaligned || !memory_has_erms) && len >= MEMORY_SSE2_MIN)
     {
-        d[i] = s[i];
+        while ((uintptr_t)d & 15)
+        {
+            *(uint32_t*)d = *(const uint32_t*)s;
+            d += 4;
+            s += 4;
+            len -= 4;
+        }
+
+        size_t blocks = len / 64;
+        memory_copy_sse2(d, s, blocks);
+        d += blocks * 64;
+        s += blocks * 64;
+        len -= blocks * 64;
     }
+
+    size_t words = len / 4;
+    __asm__ volatile("rep movsl" : "+D"(d), "+S"(s), "+c"(words) : : "memory");
+
+    len &= 3;
+    while (len--)
+    {
+        *d++ = *s++;
+    }
+}
+
+void* memcpy(void* dest, const void* src, size_t len)  // FIXED
+{
+    memory_copy_forward((uint8_t*)dest, (const uint8_t*)src, len);
     return dest;
 }
 
@@ -41,20 +268,39 @@ void* memmove(void* dest, const void* src, size_t n)
 {
     unsigned char* d = (unsigned char*)dest;
     const unsigned char* s = (const unsigned char*)src;
-    
-    if (d < s)
+
+    // ADDED: Forward is safe unless dest starts inside src
+    if (d <= s || d >= s + n)
     {
-        // ADDED: Copy forward (source is before destination)
-        for (size_t i = 0; i < n; i++)
-            d[i] = s[i];
+        memory_copy_forward(d, s, n);
+        return dest;
     }
-    else if (d > s)
+
+    // ADDED: Copy backward (destination overlaps the end of source)
+    d += n;
+    s += n;
+    if (memory_path != MEMORY_PATH_BYTES && n >= MEMORY_BACKWARD_MIN)
     {
-        // ADDED: Copy backward (destination is before source)
-        for (size_t i = n; i > 0; i--)
-            d[i - 1] = s[i - 1];
+        while ((uintptr_t)d & 3)
+        {
+            *--d = *--s;
+            n--;
+        }
+
+        // rep movsl with DF set walks down from the last word
+        size_t words = n / 4;
+        d -= 4;
+        s -= 4;
+        __asm__ volatile("std\n\trep movsl\n\tcld" : "+D"(d), "+S"(s), "+c"(words) : : "memory");
+        d += 4;
+        s += 4;
+        n &= 3;
     }
-    // ADDED: If d == s, do nothing (same address)
-    
+
+    while (n--)
+    {
+        *--d = *--s;
+    }
+
     return dest;
-}
\ No newline at end of file
+}
@@ -2,10 +2,21 @@
 #define MEMORY_H
 
 #include <stddef.h>
+#include <stdbool.h>
+
+// ADDED: How mem* do the bulk of their work. memory_init() picks the best
+// one the CPU has; memory_set_path() is there for benchmarks.
+#define MEMORY_PATH_BYTES 0  // One byte at a time
+#define MEMORY_PATH_WORDS 1  // rep stosl / rep movsl
+#define MEMORY_PATH_SSE2 2   // 16 byte XMM loads and stores for large sizes
+
+void memory_init();
+int memory_get_path();
+bool memory_set_path(int path);
 
 void* memset(void* ptr, int c, size_t size);
 int memcmp(void* s1, void* s2, int count);
 void* memcpy(void* dest, const void* src, size_t len);  // FIXED: size_t
 void* memmove(void* dest, const void* src, size_t n);  // ADDED: Move memory (handles overlap)
 
-#endif
\ No newline at end of file
+#endif
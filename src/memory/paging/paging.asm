@@ -4,6 +4,7 @@ section .asm
 
 global paging_load_directory
 global enable_paging
+global paging_enable_pse
 
 paging_load_directory:
     push ebp
@@ -20,4 +21,14 @@ enable_paging:
     or eax, 0x80000000
     mov cr0, eax
     pop ebp
-    ret
\ No newline at end of file
+    ret
+
+; ADDED: Allow 4 MB pages (CR4.PSE)
+paging_enable_pse:
+    push ebp
+    mov ebp, esp
+    mov eax, cr4
+    or eax, 0x10
+    mov cr4, eax
+    pop ebp
+    ret
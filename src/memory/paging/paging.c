@@ -2,14 +2,38 @@
 #include "memory/heap/kheap.h"
 #include "status.h"
 void paging_load_directory(uint32_t *directory);
+void paging_enable_pse();
 
 static uint32_t *current_directory = 0;
+
+bool paging_has_pse()
+{
+    // ADDED: CPUID leaf 1, EDX bit 3
+    uint32_t eax = 1, ebx, ecx, edx;
+    __asm__ volatile("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx & (1 << 3)) != 0;
+}
+
 struct paging_4gb_chunk *paging_new_4gb(uint8_t flags)
 {
     uint32_t *directory = kzalloc(sizeof(uint32_t) * PAGING_TOTAL_ENTRIES_PER_TABLE);
+
+    // ADDED: One 4 MB page per directory entry - 4 KB of tables instead of 4 MB
+    bool large = paging_has_pse();
+    if (large)
+    {
+        paging_enable_pse();
+    }
+
     int offset = 0;
     for (int i = 0; i < PAGING_TOTAL_ENTRIES_PER_TABLE; i++)
     {
+        if (large)
+        {
+            directory[i] = ((uint32_t)i * PAGING_LARGE_PAGE_SIZE) | flags | PAGING_IS_LARGE;
+            continue;
+        }
+
         uint32_t *entry = kzalloc(sizeof(uint32_t) * PAGING_TOTAL_ENTRIES_PER_TABLE);
         for (int b = 0; b < PAGING_TOTAL_ENTRIES_PER_TABLE; b++)
         {
@@ -30,11 +54,20 @@ void paging_switch(uint32_t *directory)
     current_directory = directory;
 }
 
+uint32_t *paging_current_directory()
+{
+    return current_directory;
+}
+
 void paging_free_4gb(struct paging_4gb_chunk *chunk)
 {
     for (int i = 0; i < 1024; i++)
     {
         uint32_t entry = chunk->directory_entry[i];
+        if (entry & PAGING_IS_LARGE)
+        {
+            continue;
+        }
         uint32_t *table = (uint32_t *)(entry & 0xfffff000);
         kfree(table);
     }
@@ -132,6 +165,35 @@ int paging_map_to(uint32_t *directory, void *virt, void *phys, void *phys_end, i
 out:
     return res;
 }
+// ADDED: Replace a 4 MB page with a table of 1024 4 KB pages mapping the
+// same memory with the same flags, so part of it can be mapped differently
+static int paging_split_large(uint32_t *directory, uint32_t directory_index)
+{
+    uint32_t entry = directory[directory_index];
+    uint32_t base = entry & 0xffc00000;
+    uint32_t flags = entry & 0xfff & ~PAGING_IS_LARGE;
+
+    uint32_t *table = kzalloc(sizeof(uint32_t) * PAGING_TOTAL_ENTRIES_PER_TABLE);
+    if (!table)
+    {
+        return -ENOMEM;
+    }
+
+    for (int b = 0; b < PAGING_TOTAL_ENTRIES_PER_TABLE; b++)
+    {
+        table[b] = (base + (b * PAGING_PAGE_SIZE)) | flags;
+    }
+    directory[directory_index] = (uint32_t)table | flags | PAGING_IS_WRITEABLE;
+
+    // The old 4 MB translation may still be in the TLB
+    if (directory == current_directory)
+    {
+        paging_load_directory(directory);
+    }
+
+    return 0;
+}
+
 int paging_set(uint32_t *directory, void *virt, uint32_t val)
 {
     if (!paging_is_aligned(virt))
@@ -148,8 +210,42 @@ int paging_set(uint32_t *directory, void *virt, uint32_t val)
     }
 
     uint32_t entry = directory[directory_index];
+    if (entry & PAGING_IS_LARGE)
+    {
+        res = paging_split_large(directory, directory_index);
+        if (res < 0)
+        {
+            return res;
+        }
+        entry = directory[directory_index];
+    }
+
     uint32_t *table = (uint32_t *)(entry & 0xfffff000);
     table[table_index] = val;
 
     return 0;
-}
\ No newline at end of file
+}
+
+uint32_t paging_get(uint32_t *directory, void *virt)
+{
+    uint32_t directory_index = 0;
+    uint32_t table_index = 0;
+    if (paging_get_indexes(virt, &directory_index, &table_index) < 0)
+    {
+        return 0;
+    }
+
+    uint32_t entry = directory[directory_index];
+    if (entry & PAGING_IS_LARGE)
+    {
+        return ((entry & 0xffc00000) + (table_index * PAGING_PAGE_SIZE)) | (entry & 0xfff & ~PAGING_IS_LARGE);
+    }
+
+    uint32_t *table = (uint32_t *)(entry & 0xfffff000);
+    return table[table_index];
+}
+
+void paging_invalidate(void *virt)
+{
+    __asm__ volatile("invlpg (%0)" : : "r"(virt) : "memory");
+}
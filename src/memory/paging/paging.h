@@ -5,15 +5,23 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+// ADDED: Directory entry maps one 4 MB page itself (needs PSE, CR4 bit 4)
+#define PAGING_IS_LARGE        0b10000000
 #define PAGING_CACHE_DISABLED  0b00010000
 #define PAGING_WRITE_THROUGH   0b00001000
 #define PAGING_ACCESS_FROM_ALL 0b00000100
 #define PAGING_IS_WRITEABLE    0b00000010
 #define PAGING_IS_PRESENT      0b00000001
 
+// ADDED: Page fault error code bits
+#define PAGING_FAULT_PRESENT   0b00000001  // Protection fault, not a missing page
+#define PAGING_FAULT_WRITE     0b00000010
+#define PAGING_FAULT_USER      0b00000100
+
 
 #define PAGING_TOTAL_ENTRIES_PER_TABLE 1024
 #define PAGING_PAGE_SIZE 4096
+#define PAGING_LARGE_PAGE_SIZE (PAGING_TOTAL_ENTRIES_PER_TABLE * PAGING_PAGE_SIZE)
 
 
 struct paging_4gb_chunk
@@ -21,11 +29,25 @@ struct paging_4gb_chunk
     uint32_t* directory_entry;
 };
 
+// ADDED: Identity maps all 4 GB. With PSE every directory entry is a 4 MB
+// page and no tables are allocated; paging_set() and friends split a 4 MB
+// page into a 4 KB table the first time something inside it is remapped.
+// Without PSE all 1024 tables are built up front as before.
 struct paging_4gb_chunk* paging_new_4gb(uint8_t flags);
+
+// ADDED: True if the CPU supports 4 MB pages
+bool paging_has_pse();
+
 void paging_switch(uint32_t* directory);
 void enable_paging();
 
 int paging_set(uint32_t* directory, void* virt, uint32_t val);
+// ADDED: The table entry for virt (for a 4 MB page, the 4 KB entry it stands for)
+uint32_t paging_get(uint32_t* directory, void* virt);
+// ADDED: Drop virt's translation from the TLB after changing its entry
+void paging_invalidate(void* virt);
+// ADDED: The directory paging_switch() loaded last
+uint32_t* paging_current_directory();
 bool paging_is_aligned(void* addr);
 
 uint32_t* paging_4gb_chunk_get_directory(struct paging_4gb_chunk* chunk);
@@ -0,0 +1,72 @@
+#include "pci.h"
+#include "io/io.h"
+#include "status.h"
+
+#define PCI_MAX_BUSES 256
+#define PCI_MAX_SLOTS 32
+#define PCI_MAX_FUNCTIONS 8
+
+static uint32_t pci_address(uint8_t bus, uint8_t slot, uint8_t function, uint8_t reg)
+{
+    return 0x80000000 | ((uint32_t)bus << 16) | ((uint32_t)slot << 11) |
+           ((uint32_t)function << 8) | (reg & 0xFC);
+}
+
+static uint32_t pci_read(uint8_t bus, uint8_t slot, uint8_t function, uint8_t reg)
+{
+    outl(PCI_CONFIG_ADDRESS, pci_address(bus, slot, function, reg));
+    return insl(PCI_CONFIG_DATA);
+}
+
+uint32_t pci_config_read(struct pci_device* device, uint8_t reg)
+{
+    return pci_read(device->bus, device->slot, device->function, reg);
+}
+
+void pci_config_write(struct pci_device* device, uint8_t reg, uint32_t value)
+{
+    outl(PCI_CONFIG_ADDRESS, pci_address(device->bus, device->slot, device->function, reg));
+    outl(PCI_CONFIG_DATA, value);
+}
+
+// Brute force: every bus, slot and function (there are only a few on QEMU)
+int pci_find_class(uint8_t class_code, uint8_t subclass, struct pci_device* out)
+{
+    for (int bus = 0; bus < PCI_MAX_BUSES; bus++)
+    {
+        for (int slot = 0; slot < PCI_MAX_SLOTS; slot++)
+        {
+            for (int function = 0; function < PCI_MAX_FUNCTIONS; function++)
+            {
+                uint32_t id = pci_read(bus, slot, function, PCI_REG_VENDOR_ID);
+                if ((id & 0xFFFF) == 0xFFFF)
+                {
+                    // No function 0 means no device in this slot at all
+                    if (function == 0)
+                        break;
+                    continue;
+                }
+
+                uint32_t class_reg = pci_read(bus, slot, function, PCI_REG_CLASS);
+                if ((class_reg >> 24) == class_code && ((class_reg >> 16) & 0xFF) == subclass)
+                {
+                    out->bus = bus;
+                    out->slot = slot;
+                    out->function = function;
+                    out->vendor_id = id & 0xFFFF;
+                    out->device_id = id >> 16;
+                    out->class_code = class_code;
+                    out->subclass = subclass;
+                    out->prog_if = (class_reg >> 8) & 0xFF;
+                    return 0;
+                }
+
+                // Single-function devices only answer on function 0
+                if (function == 0 && !(pci_read(bus, slot, 0, PCI_REG_HEADER_TYPE) & 0x00800000))
+                    break;
+            }
+        }
+    }
+
+    return -EIO;
+}
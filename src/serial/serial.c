@@ -0,0 +1,164 @@
+#include "serial.h"
+#include "io/io.h"
+
+// ADDED: UART registers (offsets from the base port)
+#define SERIAL_DATA        0   // THR (write) / RBR (read); divisor low with DLAB
+#define SERIAL_IER         1   // Interrupt enable; divisor high with DLAB
+#define SERIAL_IIR         2   // Interrupt identification (read) / FIFO control (write)
+#define SERIAL_LCR         3
+#define SERIAL_MCR         4
+#define SERIAL_LSR         5
+
+#define SERIAL_IER_THRE    0x02
+#define SERIAL_LSR_THRE    0x20
+#define SERIAL_FIFO_SIZE   16
+
+static bool serial_present = false;
+
+// ADDED: Transmit ring. serial_write() only moves the head and the
+// interrupt handler only moves the tail.
+static char serial_tx[SERIAL_TX_BUFFER_SIZE];
+static volatile uint32_t serial_tx_head = 0;
+static volatile uint32_t serial_tx_tail = 0;
+static volatile bool serial_tx_irq_on = false;
+static uint32_t serial_dropped = 0;
+
+static inline uint32_t serial_irq_save()
+{
+    uint32_t flags;
+    __asm__ volatile("pushfl; popl %0; cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+static inline void serial_irq_restore(uint32_t flags)
+{
+    __asm__ volatile("pushl %0; popfl" : : "r"(flags) : "memory", "cc");
+}
+
+bool serial_init()
+{
+    outb(SERIAL_COM1 + SERIAL_IER, 0x00);
+
+    // ADDED: 115200 baud (divisor 1), 8 data bits, no parity, 1 stop bit
+    outb(SERIAL_COM1 + SERIAL_LCR, 0x80);
+    outb(SERIAL_COM1 + SERIAL_DATA, 0x01);
+    outb(SERIAL_COM1 + SERIAL_IER, 0x00);
+    outb(SERIAL_COM1 + SERIAL_LCR, 0x03);
+
+    // ADDED: Enable and clear the FIFOs
+    outb(SERIAL_COM1 + SERIAL_IIR, 0xC7);
+
+    // ADDED: Loopback test - a missing UART reads back 0xFF
+    outb(SERIAL_COM1 + SERIAL_MCR, 0x1E);
+    outb(SERIAL_COM1 + SERIAL_DATA, 0xAE);
+    if (insb(SERIAL_COM1 + SERIAL_DATA) != 0xAE)
+    {
+        serial_present = false;
+        return false;
+    }
+
+    // ADDED: Normal operation: DTR, RTS and OUT2 (OUT2 gates the IRQ line)
+    outb(SERIAL_COM1 + SERIAL_MCR, 0x0B);
+
+    serial_tx_head = 0;
+    serial_tx_tail = 0;
+    serial_tx_irq_on = false;
+    serial_present = true;
+    return true;
+}
+
+// ADDED: Push up to a FIFO's worth of queued bytes into the UART
+static void serial_fill_fifo()
+{
+    for (int i = 0; i < SERIAL_FIFO_SIZE && serial_tx_tail != serial_tx_head; i++)
+    {
+        outb(SERIAL_COM1 + SERIAL_DATA, serial_tx[serial_tx_tail]);
+        serial_tx_tail = (serial_tx_tail + 1) % SERIAL_TX_BUFFER_SIZE;
+    }
+}
+
+void serial_handler()
+{
+    // ADDED: Reading IIR acknowledges the THRE interrupt
+    insb(SERIAL_COM1 + SERIAL_IIR);
+
+    if (insb(SERIAL_COM1 + SERIAL_LSR) & SERIAL_LSR_THRE)
+    {
+        serial_fill_fifo();
+    }
+
+    // ADDED: Nothing left - stop asking for THRE interrupts
+    if (serial_tx_tail == serial_tx_head)
+    {
+        outb(SERIAL_COM1 + SERIAL_IER, 0x00);
+        serial_tx_irq_on = false;
+    }
+}
+
+int serial_write(const char* data, int len)
+{
+    if (!serial_present)
+        return 0;
+
+    int written = 0;
+    while (written < len)
+    {
+        uint32_t next = (serial_tx_head + 1) % SERIAL_TX_BUFFER_SIZE;
+        if (next == serial_tx_tail)
+        {
+            serial_dropped += len - written;
+            break;
+        }
+        serial_tx[serial_tx_head] = data[written++];
+        serial_tx_head = next;
+    }
+
+    // ADDED: Enabling THRE while the transmitter is idle raises the
+    // interrupt right away, which starts the drain. Interrupts are off for
+    // the check so the handler can't switch it off in between.
+    uint32_t flags = serial_irq_save();
+    if (!serial_tx_irq_on && serial_tx_tail != serial_tx_head)
+    {
+        serial_tx_irq_on = true;
+        outb(SERIAL_COM1 + SERIAL_IER, SERIAL_IER_THRE);
+    }
+    serial_irq_restore(flags);
+
+    return written;
+}
+
+int serial_write_string(const char* str)
+{
+    int len = 0;
+    while (str[len])
+    {
+        len++;
+    }
+    return serial_write(str, len);
+}
+
+void serial_flush()
+{
+    if (!serial_present)
+        return;
+
+    uint32_t flags = serial_irq_save();
+    while (serial_tx_tail != serial_tx_head)
+    {
+        while (!(insb(SERIAL_COM1 + SERIAL_LSR) & SERIAL_LSR_THRE))
+        {
+        }
+        serial_fill_fifo();
+    }
+
+    // ADDED: Wait for the last byte to leave the shift register too
+    while (!(insb(SERIAL_COM1 + SERIAL_LSR) & 0x40))
+    {
+    }
+    serial_irq_restore(flags);
+}
+
+uint32_t serial_get_dropped()
+{
+    return serial_dropped;
+}
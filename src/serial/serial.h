@@ -0,0 +1,34 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ADDED: First 16550 UART (COM1), IRQ4 -> interrupt 0x24
+#define SERIAL_COM1 0x3F8
+#define SERIAL_IRQ_INTERRUPT 0x24
+
+// ADDED: Bytes queued for transmit; writes beyond this are dropped
+#define SERIAL_TX_BUFFER_SIZE 8192
+
+// ADDED: Program COM1 for 115200 8N1 with FIFOs. Returns false (and all
+// writes are ignored) if no UART answers the loopback test.
+bool serial_init();
+
+// ADDED: Queue bytes for transmit. Never waits: the transmit interrupt
+// drains the queue in the background, and what doesn't fit is dropped.
+// Returns the number of bytes queued.
+int serial_write(const char* data, int len);
+int serial_write_string(const char* str);
+
+// ADDED: Send everything queued by polling (for use before halting or
+// exiting, or with interrupts off)
+void serial_flush();
+
+// ADDED: Bytes dropped because the transmit queue was full
+uint32_t serial_get_dropped();
+
+// ADDED: Called by the IRQ4 assembly wrapper
+void serial_handler();
+
+#endif
@@ -0,0 +1,177 @@
+#include "telemetry.h"
+#include "serial/serial.h"
+#include "timer/timer.h"
+#include "memory/memory.h"
+
+// ADDED: Longest record; longer LOG text is cut off
+#define TELEMETRY_LINE_MAX 256
+
+static bool telemetry_on = false;
+static struct telemetry_counter* telemetry_counters = 0;
+
+bool telemetry_init()
+{
+    telemetry_on = serial_init();
+    if (telemetry_on)
+    {
+        telemetry_log("telemetry up");
+    }
+    return telemetry_on;
+}
+
+bool telemetry_enabled()
+{
+    return telemetry_on;
+}
+
+// ADDED: Tiny line builder - appends stop quietly at the end of the buffer
+struct telemetry_line
+{
+    char text[TELEMETRY_LINE_MAX];
+    int len;
+};
+
+static void telemetry_append(struct telemetry_line* line, const char* str)
+{
+    while (*str && line->len < TELEMETRY_LINE_MAX - 1)
+    {
+        line->text[line->len++] = *str++;
+    }
+}
+
+static void telemetry_append_uint(struct telemetry_line* line, uint32_t value)
+{
+    char digits[10];
+    int count = 0;
+    do
+    {
+        digits[count++] = '0' + (value % 10);
+        value /= 10;
+    } while (value);
+
+    while (count > 0 && line->len < TELEMETRY_LINE_MAX - 1)
+    {
+        line->text[line->len++] = digits[--count];
+    }
+}
+
+static void telemetry_begin(struct telemetry_line* line, const char* kind)
+{
+    line->len = 0;
+    telemetry_append(line, kind);
+    telemetry_append(line, " ");
+    telemetry_append_uint(line, timer_get_ticks());
+}
+
+static void telemetry_send(struct telemetry_line* line)
+{
+    // ADDED: Always room for the newline (appends stop one short)
+    line->text[line->len++] = '\n';
+    serial_write(line->text, line->len);
+}
+
+void telemetry_log(const char* text)
+{
+    if (!telemetry_on)
+        return;
+
+    struct telemetry_line line;
+    telemetry_begin(&line, "LOG");
+    telemetry_append(&line, " ");
+    telemetry_append(&line, text);
+    telemetry_send(&line);
+}
+
+void telemetry_value(const char* name, uint32_t value)
+{
+    if (!telemetry_on)
+        return;
+
+    struct telemetry_line line;
+    telemetry_begin(&line, "CNT");
+    telemetry_append(&line, " ");
+    telemetry_append(&line, name);
+    telemetry_append(&line, " ");
+    telemetry_append_uint(&line, value);
+    telemetry_send(&line);
+}
+
+void telemetry_frame(uint32_t frame, uint32_t frame_us)
+{
+    if (!telemetry_on)
+        return;
+
+    struct telemetry_line line;
+    telemetry_begin(&line, "FRAME");
+    telemetry_append(&line, " ");
+    telemetry_append_uint(&line, frame);
+    telemetry_append(&line, " ");
+    telemetry_append_uint(&line, frame_us);
+    telemetry_send(&line);
+}
+
+void telemetry_count(struct telemetry_counter* counter, uint32_t delta)
+{
+    counter->value += delta;
+    if (!counter->registered)
+    {
+        counter->registered = true;
+        counter->next = telemetry_counters;
+        telemetry_counters = counter;
+    }
+}
+
+void telemetry_publish_counters()
+{
+    for (struct telemetry_counter* c = telemetry_counters; c; c = c->next)
+    {
+        telemetry_value(c->name, c->value);
+    }
+}
+
+void telemetry_histogram_init(struct telemetry_histogram* histogram, const char* name, uint32_t bucket_width)
+{
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->name = name;
+    histogram->bucket_width = bucket_width ? bucket_width : 1;
+}
+
+void telemetry_histogram_add(struct telemetry_histogram* histogram, uint32_t value)
+{
+    uint32_t bucket = value / histogram->bucket_width;
+    if (bucket < TELEMETRY_HISTOGRAM_BUCKETS)
+        histogram->buckets[bucket]++;
+    else
+        histogram->overflow++;
+    histogram->samples++;
+}
+
+void telemetry_histogram_reset(struct telemetry_histogram* histogram)
+{
+    memset(histogram->buckets, 0, sizeof(histogram->buckets));
+    histogram->overflow = 0;
+    histogram->samples = 0;
+}
+
+void telemetry_publish_histogram(struct telemetry_histogram* histogram)
+{
+    if (!telemetry_on)
+        return;
+
+    struct telemetry_line line;
+    telemetry_begin(&line, "HIST");
+    telemetry_append(&line, " ");
+    telemetry_append(&line, histogram->name);
+    telemetry_append(&line, " ");
+    telemetry_append_uint(&line, histogram->bucket_width);
+    telemetry_append(&line, " ");
+    telemetry_append_uint(&line, histogram->samples);
+    for (int i = 0; i < TELEMETRY_HISTOGRAM_BUCKETS; i++)
+    {
+        telemetry_append(&line, " ");
+        telemetry_append_uint(&line, histogram->buckets[i]);
+    }
+    telemetry_append(&line, " ");
+    telemetry_append_uint(&line, histogram->overflow);
+    telemetry_send(&line);
+}
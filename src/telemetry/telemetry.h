@@ -0,0 +1,60 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Telemetry records go out over COM1 as one text line each, so a run under
+ * QEMU with -serial file:out.txt can be read back with grep/awk:
+ *
+ *   LOG   <ms> <text>
+ *   CNT   <ms> <name> <value>
+ *   HIST  <ms> <name> <bucket width> <samples> <bucket 0> ... <overflow>
+ *   FRAME <ms> <frame number> <frame time us>
+ *
+ * <ms> is timer_get_ticks() when the record was made. Publishing never
+ * waits on the UART; records that don't fit the transmit queue are dropped.
+ */
+
+// ADDED: A named running total. Declare with TELEMETRY_COUNTER; it joins the
+// list printed by telemetry_publish_counters() the first time it's counted.
+struct telemetry_counter
+{
+    const char* name;
+    uint32_t value;
+    bool registered;
+    struct telemetry_counter* next;
+};
+
+#define TELEMETRY_COUNTER(var, name) struct telemetry_counter var = {name, 0, false, 0}
+
+#define TELEMETRY_HISTOGRAM_BUCKETS 16
+
+// ADDED: Fixed-width buckets: [0, width), [width, 2*width), ... plus overflow
+struct telemetry_histogram
+{
+    const char* name;
+    uint32_t bucket_width;
+    uint32_t buckets[TELEMETRY_HISTOGRAM_BUCKETS];
+    uint32_t overflow;
+    uint32_t samples;
+};
+
+// ADDED: Bring up COM1; false if there is no UART (everything is a no-op)
+bool telemetry_init();
+bool telemetry_enabled();
+
+void telemetry_log(const char* text);
+void telemetry_value(const char* name, uint32_t value);
+void telemetry_frame(uint32_t frame, uint32_t frame_us);
+
+void telemetry_count(struct telemetry_counter* counter, uint32_t delta);
+void telemetry_publish_counters();
+
+void telemetry_histogram_init(struct telemetry_histogram* histogram, const char* name, uint32_t bucket_width);
+void telemetry_histogram_add(struct telemetry_histogram* histogram, uint32_t value);
+void telemetry_histogram_reset(struct telemetry_histogram* histogram);
+void telemetry_publish_histogram(struct telemetry_histogram* histogram);
+
+#endif
@@ -0,0 +1,93 @@
+#include "frame_pacer.h"
+#include "timer.h"
+
+static void frame_pacer_clear_stats(struct frame_pacer* pacer)
+{
+    pacer->last_frame_tick = timer_get_ticks();
+    pacer->last_frame_ms = 0;
+    pacer->frames = 0;
+    pacer->frame_ms_min = 0xFFFFFFFF;
+    pacer->frame_ms_max = 0;
+    pacer->frame_ms_total = 0;
+    pacer->jitter_total = 0;
+    pacer->dropped_steps = 0;
+}
+
+void frame_pacer_init(struct frame_pacer* pacer, uint32_t step_ms)
+{
+    pacer->step_ms = step_ms;
+    frame_pacer_reset(pacer);
+    frame_pacer_clear_stats(pacer);
+}
+
+void frame_pacer_reset(struct frame_pacer* pacer)
+{
+    pacer->last_tick = timer_get_ticks();
+    pacer->accumulator = 0;
+
+    // The gap across the pause isn't a frame time
+    pacer->last_frame_tick = pacer->last_tick;
+    pacer->last_frame_ms = 0;
+}
+
+int frame_pacer_steps(struct frame_pacer* pacer)
+{
+    uint32_t now = timer_get_ticks();
+    pacer->accumulator += now - pacer->last_tick;
+    pacer->last_tick = now;
+
+    int steps = 0;
+    while (pacer->accumulator >= pacer->step_ms && steps < FRAME_PACER_MAX_STEPS)
+    {
+        pacer->accumulator -= pacer->step_ms;
+        steps++;
+    }
+
+    // Too far behind - drop the rest rather than spiral
+    while (pacer->accumulator >= pacer->step_ms)
+    {
+        pacer->accumulator -= pacer->step_ms;
+        pacer->dropped_steps++;
+    }
+
+    return steps;
+}
+
+void frame_pacer_frame_done(struct frame_pacer* pacer)
+{
+    uint32_t now = timer_get_ticks();
+    uint32_t frame_ms = now - pacer->last_frame_tick;
+    pacer->last_frame_tick = now;
+
+    // The first frame after a reset has nothing to be compared with
+    if (pacer->last_frame_ms != 0)
+    {
+        uint32_t diff = (frame_ms > pacer->last_frame_ms) ?
+                        frame_ms - pacer->last_frame_ms : pacer->last_frame_ms - frame_ms;
+        pacer->jitter_total += diff;
+        pacer->frame_ms_total += frame_ms;
+        pacer->frames++;
+
+        if (frame_ms < pacer->frame_ms_min)
+            pacer->frame_ms_min = frame_ms;
+        if (frame_ms > pacer->frame_ms_max)
+            pacer->frame_ms_max = frame_ms;
+    }
+
+    // Zero-length frames would look like a reset; count them as 1 ms
+    pacer->last_frame_ms = (frame_ms == 0) ? 1 : frame_ms;
+}
+
+uint32_t frame_pacer_average_ms(struct frame_pacer* pacer)
+{
+    if (pacer->frames == 0)
+        return 0;
+    return pacer->frame_ms_total / pacer->frames;
+}
+
+uint32_t frame_pacer_average_jitter_ms(struct frame_pacer* pacer)
+{
+    if (pacer->frames == 0)
+        return 0;
+    return pacer->jitter_total / pacer->frames;
+}
@@ -0,0 +1,46 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <stdint.h>
+
+// Most simulation steps run in one frame after a stall (the rest of the
+// backlog is dropped instead of fast-forwarding the game)
+#define FRAME_PACER_MAX_STEPS 4
+
+// Fixed-step game clock: the simulation advances in whole steps of
+// step_ms no matter how often frames are presented, and every presented
+// frame is timed so the cadence can be checked.
+struct frame_pacer
+{
+    uint32_t step_ms;
+    uint32_t last_tick;      // Tick the accumulator was last advanced to
+    uint32_t accumulator;    // Elapsed time not yet simulated (ms)
+
+    // Frame time statistics (ms between presented frames)
+    uint32_t last_frame_tick;
+    uint32_t last_frame_ms;
+    uint32_t frames;
+    uint32_t frame_ms_min;
+    uint32_t frame_ms_max;
+    uint32_t frame_ms_total;
+    uint32_t jitter_total;   // Sum of |frame time - previous frame time|
+    uint32_t dropped_steps;
+};
+
+// Start pacing at step_ms per simulation step
+void frame_pacer_init(struct frame_pacer* pacer, uint32_t step_ms);
+
+// Forget elapsed time (after a pause, so the game doesn't catch up on it)
+void frame_pacer_reset(struct frame_pacer* pacer);
+
+// How many simulation steps are due now (0..FRAME_PACER_MAX_STEPS)
+int frame_pacer_steps(struct frame_pacer* pacer);
+
+// Call right after a frame was presented to record its frame time
+void frame_pacer_frame_done(struct frame_pacer* pacer);
+
+// Averages over all recorded frames (0 until two frames were presented)
+uint32_t frame_pacer_average_ms(struct frame_pacer* pacer);
+uint32_t frame_pacer_average_jitter_ms(struct frame_pacer* pacer);
+
+#endif
@@ -0,0 +1,176 @@
+#include "profiler.h"
+#include "timer.h"
+#include "stdlib/stdlib.h"
+#include "string/string.h"
+#include <stdbool.h>
+
+struct profiler_stage
+{
+    const char* name;
+    uint32_t start;
+    uint32_t frame_cycles;    // Total this frame so far
+    bool ran;
+
+    uint32_t history[PROFILER_WINDOW];
+    uint32_t next;            // Ring position of the next sample
+    uint32_t samples;         // Valid entries (up to PROFILER_WINDOW)
+};
+
+static struct profiler_stage profiler_stages[PROFILER_MAX_STAGES];
+static int profiler_count = 0;
+
+void profiler_init(const char* const* names, int count)
+{
+    if (count > PROFILER_MAX_STAGES)
+        count = PROFILER_MAX_STAGES;
+
+    memset(profiler_stages, 0, sizeof(profiler_stages));
+    for (int i = 0; i < count; i++)
+    {
+        profiler_stages[i].name = names[i];
+    }
+    profiler_count = count;
+}
+
+void profiler_begin(int stage)
+{
+    if (stage < 0 || stage >= profiler_count)
+        return;
+
+    profiler_stages[stage].start = timer_get_cycles();
+}
+
+void profiler_end(int stage)
+{
+    if (stage < 0 || stage >= profiler_count)
+        return;
+
+    struct profiler_stage* s = &profiler_stages[stage];
+    s->frame_cycles += timer_get_cycles() - s->start;
+    s->ran = true;
+}
+
+void profiler_end_frame()
+{
+    for (int i = 0; i < profiler_count; i++)
+    {
+        struct profiler_stage* s = &profiler_stages[i];
+        if (!s->ran)
+            continue;
+
+        s->history[s->next] = s->frame_cycles;
+        s->next = (s->next + 1) % PROFILER_WINDOW;
+        if (s->samples < PROFILER_WINDOW)
+            s->samples++;
+
+        s->frame_cycles = 0;
+        s->ran = false;
+    }
+}
+
+int profiler_stage_count()
+{
+    return profiler_count;
+}
+
+const char* profiler_stage_name(int stage)
+{
+    if (stage < 0 || stage >= profiler_count)
+        return "";
+    return profiler_stages[stage].name;
+}
+
+void profiler_get_stats(int stage, struct profiler_stats* stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (stage < 0 || stage >= profiler_count)
+        return;
+
+    struct profiler_stage* s = &profiler_stages[stage];
+    if (s->samples == 0)
+        return;
+
+    // Sort a copy of the window for the percentile (small, on demand only)
+    uint32_t sorted[PROFILER_WINDOW];
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < s->samples; i++)
+    {
+        uint32_t value = s->history[i];
+        uint32_t j = i;
+        while (j > 0 && sorted[j - 1] > value)
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+        total += value;
+    }
+
+    stats->samples = s->samples;
+    stats->min = sorted[0];
+    stats->max = sorted[s->samples - 1];
+    stats->avg = timer_udiv64(total, s->samples);
+    stats->p99 = sorted[(s->samples * 99) / 100];
+}
+
+static char* profiler_append(char* out, const char* text, int width)
+{
+    // Right-aligned in a field of `width` characters
+    int len = strlen(text);
+    for (int i = len; i < width; i++)
+    {
+        *out++ = ' ';
+    }
+    strcpy(out, text);
+    return out + len;
+}
+
+static char* profiler_append_us(char* out, uint32_t cycles)
+{
+    char number[12];
+    itoa((int)timer_cycles_to_us(cycles), number);
+    return profiler_append(out, number, 7);
+}
+
+void profiler_format_header(char* line, bool brief)
+{
+    strcpy(line, brief ? "STAGE         AVG    P99" : "STAGE         MIN    AVG    MAX    P99");
+}
+
+void profiler_format_stage(int stage, char* line, bool brief)
+{
+    struct profiler_stats stats;
+    profiler_get_stats(stage, &stats);
+
+    // Name left-aligned in 10 columns
+    char* out = line;
+    strncpy(out, profiler_stage_name(stage), 11);
+    out[10] = '\0';
+    out += strlen(out);
+    while (out < line + 10)
+    {
+        *out++ = ' ';
+    }
+
+    if (!brief)
+        out = profiler_append_us(out, stats.min);
+    out = profiler_append_us(out, stats.avg);
+    if (!brief)
+        out = profiler_append_us(out, stats.max);
+    out = profiler_append_us(out, stats.p99);
+    *out = '\0';
+}
+
+void profiler_dump(void (*write_line)(const char* line))
+{
+    char line[PROFILER_LINE_MAX];
+
+    profiler_format_header(line, false);
+    write_line(line);
+
+    for (int i = 0; i < profiler_count; i++)
+    {
+        profiler_format_stage(i, line, false);
+        write_line(line);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PROFILER_MAX_STAGES 16
+
+// Longest line produced by the formatting functions, terminator included
+#define PROFILER_LINE_MAX 48
+
+// Frames of history kept per stage for the statistics
+#define PROFILER_WINDOW 128
+
+// Statistics over the last PROFILER_WINDOW frames a stage ran in (cycles)
+struct profiler_stats
+{
+    uint32_t samples;
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+};
+
+// Time a statement as one stage:
+//     PROFILE(STAGE_BALLS, update_balls());
+#define PROFILE(stage, code) \
+    do { profiler_begin(stage); code; profiler_end(stage); } while (0)
+
+// Set up count stages (names are kept by pointer) and clear all history
+void profiler_init(const char* const* names, int count);
+
+// Mark the start / end of a stage. A stage may run several times per frame;
+// the frame's sample is the total.
+void profiler_begin(int stage);
+void profiler_end(int stage);
+
+// Close the frame: stages that ran get a sample added to their history
+void profiler_end_frame();
+
+int profiler_stage_count();
+const char* profiler_stage_name(int stage);
+void profiler_get_stats(int stage, struct profiler_stats* stats);
+
+// Table text, times in microseconds: name, min, avg, max and p99, or
+// just name, avg and p99 when brief
+void profiler_format_header(char* line, bool brief);
+void profiler_format_stage(int stage, char* line, bool brief);
+
+// Write the full table (header first, then one line per stage)
+void profiler_dump(void (*write_line)(const char* line));
+
+#endif
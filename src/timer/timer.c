@@ -1,6 +1,7 @@
 #include "timer.h"
 #include "io/io.h"
 #include "idt/idt.h"
+#include <stdbool.h>
 
 // Global tick counter (incremented by IRQ0 handler)
 // ADDED: volatile tells compiler this can change at any time (from interrupt)
@@ -10,6 +11,12 @@ static volatile uint32_t g_timer_ticks = 0;
 #define PIT_FREQUENCY 1193182
 #define TARGET_FREQUENCY 1000  // 1000 Hz = 1 tick per millisecond
 
+// ADDED: TSC calibration runs PIT channel 2 for this long
+#define TSC_CALIBRATE_MS 10
+
+static bool g_has_tsc = false;
+static uint32_t g_cycles_per_ms = 1000;
+
 // ADDED: This function is called by the IRQ0 assembly wrapper
 void timer_handler()
 {
@@ -18,6 +25,58 @@ void timer_handler()
     outb(0x20, 0x20);
 }
 
+static inline uint64_t timer_rdtsc()
+{
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static bool timer_cpu_has_tsc()
+{
+    // ADDED: CPUID leaf 1, EDX bit 4
+    uint32_t eax = 1, ebx, ecx, edx;
+    __asm__ volatile("cpuid" : "+a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx));
+    return (edx & (1 << 4)) != 0;
+}
+
+// ADDED: Count TSC cycles across a fixed PIT channel 2 countdown. Channel 2
+// is polled through port 0x61 (gate in bit 0, output in bit 5), so this
+// works before interrupts are enabled and leaves IRQ0 alone.
+static void timer_calibrate_tsc()
+{
+    g_has_tsc = timer_cpu_has_tsc();
+    if (!g_has_tsc)
+        return;
+
+    uint16_t count = (PIT_FREQUENCY / 1000) * TSC_CALIBRATE_MS;
+    uint8_t port61 = insb(0x61);
+
+    // Gate on, speaker off
+    outb(0x61, (port61 & ~0x02) | 0x01);
+
+    // Channel 2, lobyte/hibyte, mode 0 (output goes high at terminal count)
+    outb(0x43, 0xB0);
+    outb(0x42, count & 0xFF);
+    outb(0x42, (count >> 8) & 0xFF);
+
+    uint64_t start = timer_rdtsc();
+    while (!(insb(0x61) & 0x20))
+    {
+    }
+    uint64_t end = timer_rdtsc();
+
+    outb(0x61, port61);
+
+    uint32_t per_ms = timer_udiv64(end - start, TSC_CALIBRATE_MS);
+    if (per_ms == 0)
+    {
+        g_has_tsc = false;
+        return;
+    }
+    g_cycles_per_ms = per_ms;
+}
+
 void timer_init()
 {
     // ADDED: Calculate divisor for desired frequency
@@ -31,6 +90,8 @@ void timer_init()
     outb(0x40, (uint8_t)((divisor >> 8) & 0xFF));
     
     // Timer will now fire IRQ0 at 1000 Hz
+
+    timer_calibrate_tsc();
 }
 
 uint32_t timer_get_ticks()
@@ -46,4 +107,34 @@ void timer_wait(uint32_t ms)
     {
         // Just wait
     }
-}
\ No newline at end of file
+}
+uint32_t timer_udiv64(uint64_t dividend, uint32_t divisor)
+{
+    uint32_t hi = (uint32_t)(dividend >> 32);
+    uint32_t lo = (uint32_t)dividend;
+
+    // ADDED: divl faults if the quotient doesn't fit - saturate instead
+    if (hi >= divisor)
+        return 0xFFFFFFFF;
+
+    uint32_t quotient, remainder;
+    __asm__("divl %4" : "=a"(quotient), "=d"(remainder) : "a"(lo), "d"(hi), "rm"(divisor));
+    return quotient;
+}
+
+uint32_t timer_get_cycles()
+{
+    if (!g_has_tsc)
+        return g_timer_ticks * 1000;
+    return (uint32_t)timer_rdtsc();
+}
+
+uint32_t timer_get_cycles_per_ms()
+{
+    return g_cycles_per_ms;
+}
+
+uint32_t timer_cycles_to_us(uint32_t cycles)
+{
+    return timer_udiv64((uint64_t)cycles * 1000, g_cycles_per_ms);
+}
@@ -12,4 +12,22 @@ uint32_t timer_get_ticks();
 // Busy-wait for specified milliseconds
 void timer_wait(uint32_t ms);
 
+// CPU timestamp counter (low 32 bits), calibrated against the PIT in
+// timer_init(). Wraps after about a second, so use it for short intervals:
+//     uint32_t start = timer_get_cycles();
+//     ...
+//     uint32_t elapsed = timer_get_cycles() - start;
+// Without a TSC this falls back to the 1 ms tick (1000 "cycles" per ms).
+uint32_t timer_get_cycles();
+
+// Cycles per millisecond (the TSC rate in kHz)
+uint32_t timer_get_cycles_per_ms();
+
+// Convert a cycle count to microseconds
+uint32_t timer_cycles_to_us(uint32_t cycles);
+
+// 64-by-32-bit unsigned division (the kernel isn't linked with libgcc, so
+// plain '/' on a uint64_t doesn't link). The quotient must fit 32 bits.
+uint32_t timer_udiv64(uint64_t dividend, uint32_t divisor);
+
 #endif
\ No newline at end of file